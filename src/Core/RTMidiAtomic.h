@@ -0,0 +1,208 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiAtomic.h 
+//!  @brief RTMIDI Atomic template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_ATOMIC_H_
+#define _RT_MIDI_CORE_ATOMIC_H_
+
+#include "./RTMidiDependencies.h"
+
+//Read-modify-write operations are only used where the target supports 
+//them without locks.  On single core parts without atomic instructions 
+//(Cortex-M0/M0+, AVR) a plain read-modify-write is used instead.  That is 
+//safe for the increment/decrement pairs used by this library, because an 
+//interrupt always restores the value it changed before it returns.  An 
+//exchange is only atomic there between contexts that cannot preempt each 
+//other, such as two interrupts of the same priority.
+#ifndef RTMIDI_ATOMIC_RMW
+    #if defined(__ARM_ARCH_6M__) || defined(__AVR__)
+        #define RTMIDI_ATOMIC_RMW 0
+    #else
+        #define RTMIDI_ATOMIC_RMW 1
+    #endif
+#endif
+
+namespace RTMIDI 
+{
+    /**
+     * @brief A value shared between interrupts, threads or cores.
+     * 
+     *        Loads have acquire and stores have release semantics unless 
+     *        the relaxed versions are used.  T should be no larger than the 
+     *        target's native word.
+     * 
+     * @tparam T An integral type
+     */
+    template<typename T>
+    class Atomic 
+    {
+        public:
+            Atomic(): value(0){};
+
+            Atomic(T initialValue): value(initialValue){};
+
+            T load() const 
+            {
+                return __atomic_load_n(&value, __ATOMIC_SEQ_CST);
+            }
+
+            T loadRelaxed() const 
+            {
+                return __atomic_load_n(&value, __ATOMIC_RELAXED);
+            }
+
+            void store(T newValue)
+            {
+                __atomic_store_n(&value, newValue, __ATOMIC_SEQ_CST);
+            }
+
+            void storeRelaxed(T newValue)
+            {
+                __atomic_store_n(&value, newValue, __ATOMIC_RELAXED);
+            }
+
+            /**
+             * @brief Add to the value.
+             * 
+             * @return The value before the addition 
+             */
+            T fetchAdd(T amount)
+            {
+            #if RTMIDI_ATOMIC_RMW
+                return __atomic_fetch_add(&value, amount, __ATOMIC_SEQ_CST);
+            #else
+                T previous = value;
+                value = previous + amount;
+                return previous;
+            #endif
+            }
+
+            /**
+             * @brief Subtract from the value.
+             * 
+             * @return The value before the subtraction 
+             */
+            T fetchSub(T amount)
+            {
+            #if RTMIDI_ATOMIC_RMW
+                return __atomic_fetch_sub(&value, amount, __ATOMIC_SEQ_CST);
+            #else
+                T previous = value;
+                value = previous - amount;
+                return previous;
+            #endif
+            }
+
+            /**
+             * @brief Replace the value.
+             * 
+             * @return The value before the exchange
+             */
+            T exchange(T newValue)
+            {
+            #if RTMIDI_ATOMIC_RMW
+                return __atomic_exchange_n(&value, newValue, __ATOMIC_SEQ_CST);
+            #else
+                T previous = value;
+                value = newValue;
+                return previous;
+            #endif
+            }
+
+            /**
+             * @brief Replace the value if it still equals expected.
+             * 
+             * @param expected The value the caller last saw.  Updated with 
+             *                 the current value if they differ.
+             * @param newValue The value to store
+             * @return True if the value was replaced
+             */
+            bool compareExchange(T& expected, T newValue)
+            {
+            #if RTMIDI_ATOMIC_RMW
+                return __atomic_compare_exchange_n(&value, &expected, newValue,
+                                                   false, __ATOMIC_SEQ_CST, 
+                                                   __ATOMIC_SEQ_CST);
+            #else
+                T current = value;
+                if (current != expected)
+                {
+                    expected = current;
+                    return false;
+                }
+                value = newValue;
+                return true;
+            #endif
+            }
+
+            operator T() const { return load(); };
+
+            Atomic& operator=(T newValue)
+            {
+                store(newValue);
+                return *this;
+            }
+        protected:
+            volatile T value;
+        private:
+            Atomic(const Atomic&);
+            Atomic& operator=(const Atomic&);
+    };
+}
+#endif
@@ -0,0 +1,131 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiBufferNotifier.h 
+//!  @brief Wake up interface for message buffer consumers
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_BUFFER_NOTIFIER_H_
+#define _RT_MIDI_CORE_BUFFER_NOTIFIER_H_
+
+#include "./RTMidiDependencies.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Interface class for waking a buffer's consumer when data 
+     *        arrives, so that it can sleep instead of polling.
+     * 
+     *        A buffer only calls notify() when it goes from empty to not 
+     *        empty, so a burst of messages costs one notification.  
+     *        Notifications must be remembered: a notify() that happens 
+     *        before wait() makes the next wait() return immediately.  
+     *        wait() may also return spuriously, so consumers check the 
+     *        buffer again after waking.
+     * 
+     *        On an RTOS, implement this with a semaphore or task 
+     *        notification.
+     */
+    class BufferNotifier 
+    {
+        public:
+            virtual ~BufferNotifier(){};
+
+            /**
+             * @brief Wake the consumer.  Called by the producer, which may 
+             *        be an interrupt.
+             */
+            virtual void notify() = 0;
+
+            /**
+             * @brief Sleep until notify() is called.
+             * 
+             * @param timeoutMillis The longest time to sleep, or -1 to wait 
+             *        without a timeout.  Notifiers that cannot time out may 
+             *        ignore this.
+             * @return False if the wait timed out
+             */
+            virtual bool wait(int timeoutMillis = -1) = 0;
+    };
+
+#if defined(__ARM_ARCH)
+    /**
+     * @brief BufferNotifier that sleeps the core with WFE.
+     * 
+     *        On Cortex-M, returning from the interrupt that pushed the 
+     *        message already sets the event register, so the SEV in 
+     *        notify() only matters when the producer runs on another core.  
+     *        WFE also wakes for unrelated events and cannot time out, so 
+     *        wait() always returns true.
+     */
+    class WaitForEventNotifier: public BufferNotifier 
+    {
+        public:
+            void notify() override 
+            {
+                __asm__ volatile ("dsb\n\tsev" ::: "memory");
+            }
+
+            bool wait(int timeoutMillis = -1) override 
+            {
+                __asm__ volatile ("wfe" ::: "memory");
+                return true;
+            }
+    };
+#endif
+}
+
+#endif
@@ -67,6 +67,19 @@
 #include "./RTMidiDataByte.h"
 #include "./RTMidiStatusByte.h"
 #include "./RTMidiMessage.h"
+#include "./RTMidiHistogram.h"
+#include "./RTMidiLatencyMonitor.h"
+#include "./RTMidiBufferNotifier.h"
+#include "./RTMidiTelemetry.h"
+#include "./RTMidiFlightRecorder.h"
 #include "./RTMidiMessageBuffer.h"
+#include "./RTMidiMessageSpan.h"
+#include "./RTMidiNoteBitmap.h"
+#include "./RTMidiParameterNumber.h"
+#include "./RTMidiMessageFilter.h"
+#include "./RTMidiIndexSequence.h"
+#include "./RTMidiMessageSequence.h"
+#include "./RTMidiAtomic.h"
+#include "./RTMidiDoubleBuffer.h"
 
 #endif
\ No newline at end of file
@@ -127,6 +127,52 @@ namespace RTMIDI
         Resset = 0xFF
     };
 
+    enum class ControllerNumber: Byte
+    {
+        BankSelect = 0,
+        ModulationWheel = 1,
+        DataEntryMsb = 6,
+        Volume = 7,
+        Pan = 10,
+        Expression = 11,
+        BankSelectLsb = 32,
+        DataEntryLsb = 38,
+        SustainPedal = 64,
+        DataIncrement = 96,
+        DataDecrement = 97,
+        NRPNLsb = 98,
+        NRPNMsb = 99,
+        RPNLsb = 100,
+        RPNMsb = 101,
+        AllSoundOff = 120,
+        ResetAllControllers = 121,
+        AllNotesOff = 123
+    };
+
+    /**
+     * @brief USB-MIDI event packet Code Index Numbers (the low nibble of 
+     *        the packet header).
+     */
+    enum class CodeIndex: Byte
+    {
+        Miscellaneous = 0x0,
+        CableEvent = 0x1,
+        SystemCommon2 = 0x2,
+        SystemCommon3 = 0x3,
+        SysExStartOrContinue = 0x4,
+        SystemCommon1OrSysExEnd1 = 0x5,
+        SysExEnd2 = 0x6,
+        SysExEnd3 = 0x7,
+        NoteOff = 0x8,
+        NoteOn = 0x9,
+        PolyphonicKeyPressure = 0xA,
+        ControlChange = 0xB,
+        ProgramChange = 0xC,
+        ChannelPressure = 0xD,
+        PitchBend = 0xE,
+        SingleByte = 0xF
+    };
+
     enum Channel: Byte
     {
         Ch0 = 0,
@@ -136,7 +182,8 @@ namespace RTMIDI
         Ch4 = 4,
         Ch5 = 5,
         Ch6 = 6,
-        Ch7 = 8,
+        Ch7 = 7,
+        Ch8 = 8,
         Ch9 = 9,
         Ch10 = 10,
         Ch11 = 11,
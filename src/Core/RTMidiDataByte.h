@@ -116,12 +116,12 @@ namespace RTMIDI
 
             static constexpr bool lowNibbleMatches(Byte byte, Byte test)
             {
-                return ((byte && 0xF) == (test && 0xF));
+                return ((byte & 0xF) == (test & 0xF));
             }
 
             static constexpr bool highNibbleMatches(Byte byte, Byte test)
             {
-                return ((byte && 0xF0) == (test << 4));
+                return ((byte >> 4) == (test & 0xF));
             }
 
             static constexpr Byte setLowNibbleInByte(Byte original, Byte newNibble)
@@ -147,65 +147,66 @@ namespace RTMIDI
                        (static_cast<Word>(lsb) & 0x7F);
             }
 
-            DataByte(Byte byte): c(byte){};
+            constexpr DataByte(Byte byte): c(byte){};
 
-            DataByte(): c(Invalid){};
+            constexpr DataByte(): c(Invalid){};
 
-            bool isDataByte() const { return isDataByte(c); };
+            constexpr bool isDataByte() const { return isDataByte(c); };
 
-            bool isStatusByte() const { return isStatusByte(c); };
+            constexpr bool isStatusByte() const { return isStatusByte(c); };
 
-            bool isNotDataByte() const { return isNotDataByte(c); };
+            constexpr bool isNotDataByte() const { return isNotDataByte(c); };
 
-            bool isNotStatusByte() const { return isNotStatusByte(c); };
+            constexpr bool isNotStatusByte() const { return isNotStatusByte(c); };
 
-            bool isValid() const { return isValid(c); };
+            constexpr bool isValid() const { return isValid(c); };
 
-            bool isInvalid() const { return isInvalid(c); };
+            constexpr bool isInvalid() const { return isInvalid(c); };
 
-            Byte lowNibble() const { return lowNibble(c); };
+            constexpr Byte lowNibble() const { return lowNibble(c); };
 
-            Byte highNibble() const { return highNibble(c); };
+            constexpr Byte highNibble() const { return highNibble(c); };
 
-            bool lowNibbleMatches(Byte test) const 
+            constexpr bool lowNibbleMatches(Byte test) const 
             { 
                 return lowNibbleMatches(c, test);
             };
 
-            bool highNibbleMatches(Byte test) const 
+            constexpr bool highNibbleMatches(Byte test) const 
             {
                 return highNibbleMatches(c, test);
             };
 
-            bool matches(Byte test) const { return (c == test); };
+            constexpr bool matches(Byte test) const { return (c == test); };
 
-            operator Byte() const { return c; };
+            constexpr operator Byte() const { return c; };
 
-            explicit operator bool() const { return isDataByte(); };
+            constexpr explicit operator bool() const { return isDataByte(); };
 
-            DataByte operator=(Byte b)
+            DataByte& operator=(Byte b)
             {
-                return DataByte(b);
+                c = b;
+                return *this;
             }
 
-            friend DataByte operator%(DataByte a, Byte b)
+            friend constexpr DataByte operator%(DataByte a, Byte b)
             {
                 return DataByte(a.c % b);
             };
 
-            friend DataByte operator^(DataByte a, Byte b)
+            friend constexpr DataByte operator^(DataByte a, Byte b)
             {
                 return DataByte(a.c ^ b);
             };
 
-            friend DataByte operator&(DataByte a, Byte b)
+            friend constexpr DataByte operator&(DataByte a, Byte b)
             {
                 return DataByte(a.c & b);
             };
 
-            friend DataByte operator|(DataByte a, Byte b)
+            friend constexpr DataByte operator|(DataByte a, Byte b)
             {
-                return DataByte(a.c & b);
+                return DataByte(a.c | b);
             };
 
         protected:
@@ -66,6 +66,58 @@
 namespace RTMIDI 
 {
     constexpr uint32_t UartBaudrate = 31250;
+
+    /**
+     * @brief The speed of a link carrying a MIDI byte stream.
+     */
+    struct LinkSpeed 
+    {
+        /**
+         * @brief The raw bit rate of the link
+         */
+        uint32_t bitsPerSecond;
+
+        /**
+         * @brief The bits on the wire for each MIDI byte, including any
+         *        framing overhead (10 for a UART with one start and one 
+         *        stop bit).
+         */
+        uint32_t bitsPerByte;
+
+        /**
+         * @brief Get the time it takes to send one byte.
+         * 
+         * @return The byte time in nanoseconds
+         */
+        constexpr uint32_t nanosPerByte() const 
+        {
+            return (1000000000ul / bitsPerSecond) * bitsPerByte;
+        }
+
+        /**
+         * @brief Get the link speed of an asynchronous serial link.
+         * 
+         * @param baudrate The baud rate (UartBaudrate for DIN MIDI)
+         */
+        static constexpr LinkSpeed uart(uint32_t baudrate)
+        {
+            return LinkSpeed{baudrate, 10};
+        }
+
+        /**
+         * @brief Get the link speed of a link specified by its usable 
+         *        MIDI byte throughput, such as USB.
+         */
+        static constexpr LinkSpeed bytesPerSecond(uint32_t rate)
+        {
+            return LinkSpeed{rate * 8, 8};
+        }
+    };
+
+    /**
+     * @brief The speed of a standard DIN MIDI link, 3125 bytes per second
+     */
+    constexpr LinkSpeed MidiLinkSpeed = LinkSpeed::uart(UartBaudrate);
 }
 
 #endif
\ No newline at end of file
@@ -63,4 +63,45 @@
 
 #include <stdint.h>
 
+//Host (Linux) only components in src/Host are compiled when this is 1
+#ifndef RTMIDI_HOST_LINUX
+    #if defined(__linux__) && !defined(ARDUINO)
+        #define RTMIDI_HOST_LINUX 1
+    #else
+        #define RTMIDI_HOST_LINUX 0
+    #endif
+#endif
+
+//Latency probes on the receive to transmit path (see RTMidiLatencyMonitor.h)
+//are compiled in when this is 1.  It changes the layout of the parser and 
+//message buffers, so set it as a build flag for every translation unit.
+#ifndef RTMIDI_ENABLE_LATENCY_PROBES
+    #define RTMIDI_ENABLE_LATENCY_PROBES 0
+#endif
+
+//Device telemetry counters (see RTMidiTelemetry.h) are compiled in when 
+//this is 1.  Like the latency probes, set it for every translation unit.
+#ifndef RTMIDI_ENABLE_TELEMETRY
+    #define RTMIDI_ENABLE_TELEMETRY 0
+#endif
+
+//Constant data that should stay in flash, such as a MessageSequence image,
+//is marked RTMIDI_PROGMEM and read with RTMIDI_READ_FLASH_BYTE().  On AVR 
+//constant data is otherwise copied to RAM at start up, and flash has its 
+//own address space.  Everywhere else flash is read like RAM.
+#if defined(__AVR__)
+    #include <avr/pgmspace.h>
+    #define RTMIDI_PROGMEM PROGMEM
+    #define RTMIDI_READ_FLASH_BYTE(address) pgm_read_byte(address)
+#else
+    #define RTMIDI_PROGMEM
+    #define RTMIDI_READ_FLASH_BYTE(address) (*(address))
+#endif
+
+//Parsers and transmitters can feed a FlightRecorder (see 
+//RTMidiFlightRecorder.h) when this is 1.  Set it for every translation unit.
+#ifndef RTMIDI_ENABLE_FLIGHT_RECORDER
+    #define RTMIDI_ENABLE_FLIGHT_RECORDER 0
+#endif
+
 #endif
\ No newline at end of file
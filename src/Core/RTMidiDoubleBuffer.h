@@ -0,0 +1,250 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiDoubleBuffer.h 
+//!  @brief RTMIDI DoubleBuffer template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_DOUBLE_BUFFER_H_
+#define _RT_MIDI_CORE_DOUBLE_BUFFER_H_
+
+#include "./RTMidiAtomic.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Two copies of a configuration object, one live and one being 
+     *        edited, swapped atomically.
+     * 
+     *        Realtime code (interrupts, dispatch loops) reads the live copy 
+     *        through a ReadLock, which never blocks.  Control code edits the
+     *        other copy with edit() and makes it live with publish().  A 
+     *        reader therefore always sees one complete configuration, 
+     *        either the old one or the new one.
+     * 
+     *        edit() waits until no reader is still using the copy it is 
+     *        about to reuse (the configuration that was live before the 
+     *        last publish), so it must not be called while the calling 
+     *        context holds a ReadLock.  tryEdit() returns nullptr instead
+     *        of waiting.  There may only be one editor at a time.
+     * 
+     * @tparam T The configuration type.  It must be copy assignable.
+     */
+    template<class T>
+    class DoubleBuffer 
+    {
+        public:
+            /**
+             * @brief Holds the live configuration for reading.  Keep the 
+             *        lock for as short a time as possible.
+             */
+            class ReadLock 
+            {
+                public:
+                    ReadLock(DoubleBuffer& doubleBuffer): 
+                        buffer(doubleBuffer), slot(doubleBuffer.acquire()){};
+
+                    ~ReadLock(){ buffer.release(slot); };
+
+                    const T& operator*() const { return buffer.slots[slot]; };
+
+                    const T* operator->() const { return &buffer.slots[slot]; };
+                private:
+                    DoubleBuffer& buffer;
+                    const Byte slot;
+                    ReadLock(const ReadLock&);
+                    ReadLock& operator=(const ReadLock&);
+            };
+
+            /**
+             * @brief Holds the live configuration for reading across
+             *        several calls, such as every message of one dispatch
+             *        pass.  hold() takes the configuration that is live at
+             *        the first call and keeps returning it until release().
+             */
+            class Reader
+            {
+                public:
+                    Reader(DoubleBuffer& doubleBuffer):
+                        buffer(doubleBuffer), slot(0), held(false){};
+
+                    ~Reader(){ release(); };
+
+                    const T& hold()
+                    {
+                        if (!held)
+                        {
+                            slot = buffer.acquire();
+                            held = true;
+                        }
+                        return buffer.slots[slot];
+                    }
+
+                    void release()
+                    {
+                        if (!held) return;
+                        held = false;
+                        buffer.release(slot);
+                    }
+
+                    bool isHeld() const { return held; };
+                private:
+                    DoubleBuffer& buffer;
+                    Byte slot;
+                    bool held;
+                    Reader(const Reader&);
+                    Reader& operator=(const Reader&);
+            };
+
+            DoubleBuffer(): slots(), active(0), epoch(0), editing(false){};
+
+            DoubleBuffer(const T& initial): 
+                slots{initial, initial}, active(0), epoch(0), editing(false){};
+
+            /**
+             * @brief Get the copy being edited, starting a new edit from the 
+             *        live configuration if none is in progress.  Waits for 
+             *        readers still using that copy to finish.
+             */
+            T& edit()
+            {
+                T* copy = nullptr;
+                while (!copy) copy = tryEdit();
+                return *copy;
+            }
+
+            /**
+             * @brief Get the copy being edited, or nullptr if a reader is 
+             *        still using it.
+             */
+            T* tryEdit()
+            {
+                Byte back = 1 - active.load();
+                if (readers[back].load() != 0) return nullptr;
+                if (!editing)
+                {
+                    slots[back] = slots[1 - back];
+                    editing = true;
+                }
+                return &slots[back];
+            }
+
+            /**
+             * @brief Make the edited copy the live configuration.
+             */
+            void publish()
+            {
+                if (!editing) return;
+                editing = false;
+                active.store(1 - active.load());
+                epoch.store(epoch.load() + 1);
+            }
+
+            /**
+             * @brief Abandon the current edit.
+             */
+            void discard()
+            {
+                editing = false;
+            }
+
+            /**
+             * @brief Read the live configuration from the editing context.
+             *        Realtime readers must use a ReadLock instead.
+             */
+            const T& live() const 
+            {
+                return slots[active.load()];
+            }
+
+            /**
+             * @brief Get the number of times a configuration has been 
+             *        published.
+             */
+            Word getEpoch() const 
+            {
+                return epoch.load();
+            }
+        protected:
+            T slots[2];
+            Atomic<Byte> active;
+            Atomic<Byte> readers[2];
+            Atomic<Word> epoch;
+            bool editing;
+
+            Byte acquire()
+            {
+                while (true)
+                {
+                    Byte slot = active.load();
+                    readers[slot].fetchAdd(1);
+                    //If a publish happened in between, the slot may be 
+                    //about to be edited, so try again.
+                    if (active.load() == slot) return slot;
+                    readers[slot].fetchSub(1);
+                }
+            }
+
+            void release(Byte slot)
+            {
+                readers[slot].fetchSub(1);
+            }
+        private:
+            DoubleBuffer(const DoubleBuffer&);
+            DoubleBuffer& operator=(const DoubleBuffer&);
+    };
+}
+#endif
@@ -0,0 +1,112 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiFlightRecorder.cpp 
+//!  @brief Fixed memory recorder of the last bytes received and transmitted
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiFlightRecorder.h"
+
+using namespace RTMIDI;
+
+constexpr Word FlightTrack::MaxDelta;
+constexpr Byte FlightRecorder::DumpVersion;
+
+static void putWord(Byte* out, Word value)
+{
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = (value >> 24) & 0xFF;
+}
+
+bool FlightRecorder::dump(FlightDumpWriter& writer, uint32_t ticksPerSecond)
+{
+    bool wasFrozen = frozen;
+    freeze();
+
+    Byte header[12] = {'R', 'T', 'F', 'R', DumpVersion, 
+                       static_cast<Byte>(wasFrozen ? 1 : 0), 0, 0};
+    putWord(header + 8, ticksPerSecond);
+    if (!writer.write(header, sizeof(header))) return false;
+    if (!dumpTrack(writer, received)) return false;
+    return dumpTrack(writer, transmitted);
+}
+
+bool FlightRecorder::dumpTrack(FlightDumpWriter& writer, const FlightTrack& track)
+{
+    unsigned int count = track.count();
+    Byte header[12];
+    putWord(header, count);
+    putWord(header + 4, track.getRecorded());
+    putWord(header + 8, track.getNewestTime());
+    if (!writer.write(header, sizeof(header))) return false;
+
+    //Written in blocks to keep the stack small
+    Byte block[64];
+    unsigned int used = 0;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        putWord(block + used, track.entryAt(i));
+        used += 4;
+        if (used == sizeof(block))
+        {
+            if (!writer.write(block, used)) return false;
+            used = 0;
+        }
+    }
+    return (used == 0) || writer.write(block, used);
+}
@@ -0,0 +1,269 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiFlightRecorder.h 
+//!  @brief Fixed memory recorder of the last bytes received and transmitted
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_FLIGHT_RECORDER_H_
+#define _RT_MIDI_CORE_FLIGHT_RECORDER_H_
+
+#include "./RTMidiDependencies.h"
+#include "./RTMidiCoreTypes.h"
+#include "./RTMidiAtomic.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The last bytes seen in one direction.
+     * 
+     *        Each byte is stored in one Word with the time since the 
+     *        previous byte in the upper 24 bits.  Gaps longer than that 
+     *        are stored as MaxDelta.  Absolute times are recovered by 
+     *        counting back from the time of the newest byte.
+     * 
+     *        Only one context may record into a track.
+     */
+    class FlightTrack 
+    {
+        public:
+            static constexpr Word MaxDelta = 0xFFFFFF;
+
+            /**
+             * @param storage The entries
+             * @param length The number of entries, a power of two
+             */
+            FlightTrack(Word* storage, unsigned int length): 
+                entries(storage), mask(length - 1), head(0), newestTime(0){};
+
+            void record(Byte byte, Word now)
+            {
+                Word written = head.loadRelaxed();
+                Word delta = now - newestTime;
+                if (written == 0) delta = 0;
+                else if (delta > MaxDelta) delta = MaxDelta;
+                newestTime = now;
+                entries[written & mask] = (delta << 8) | byte;
+                head.store(written + 1);
+            }
+
+            /**
+             * @brief Get the number of entries held.
+             */
+            unsigned int count() const 
+            {
+                Word written = head.load();
+                return (written > mask) ? (mask + 1) : written;
+            }
+
+            /**
+             * @brief Get the total number of bytes recorded, including 
+             *        those overwritten.
+             */
+            Word getRecorded() const { return head.load(); };
+
+            Word getNewestTime() const { return newestTime; };
+
+            /**
+             * @brief Get an entry.
+             * 
+             * @param index The entry, 0 being the oldest held
+             */
+            Word entryAt(unsigned int index) const 
+            {
+                Word written = head.load();
+                return entries[(written - count() + index) & mask];
+            }
+
+            static Byte entryByte(Word entry){ return entry & 0xFF; };
+
+            static Word entryDelta(Word entry){ return entry >> 8; };
+
+            void clear()
+            {
+                head.store(0);
+                newestTime = 0;
+            }
+        protected:
+            Word* entries;
+            Word mask;
+            Atomic<Word> head;
+            Word newestTime;
+    };
+
+    /**
+     * @brief Interface class for the destination of a flight recorder 
+     *        dump, such as a file or a serial port.
+     */
+    class FlightDumpWriter 
+    {
+        public:
+            virtual ~FlightDumpWriter(){};
+
+            /**
+             * @return False if writing failed and the dump should stop
+             */
+            virtual bool write(const Byte* data, unsigned int length) = 0;
+    };
+
+    /**
+     * @brief Black box recorder of the bytes a device received and 
+     *        transmitted.
+     * 
+     *        When RTMIDI_ENABLE_FLIGHT_RECORDER is 1, a parser or 
+     *        transmitter with an attached recorder records every byte, 
+     *        which costs a clock read and two stores.  Recording stops 
+     *        when the recorder is frozen, for example by a fault handler 
+     *        or when a hang is detected, so the bytes leading up to it 
+     *        are kept until they are dumped.
+     * 
+     *        The dump format is little endian:
+     *          - "RTFR", then a version byte (1), a flags byte (1 if 
+     *            frozen) and two reserved bytes
+     *          - the clock rate in ticks per second (0 if unknown)
+     *          - for the received, then the transmitted track: the number 
+     *            of entries, the number of bytes recorded in total, and the 
+     *            time of the newest byte, followed by the entries from 
+     *            oldest to newest as 32 bit words
+     */
+    class FlightRecorder 
+    {
+        public:
+            typedef Word (*Clock)();
+
+            static constexpr Byte DumpVersion = 1;
+
+            FlightRecorder(Clock recorderClock, 
+                           Word* receivedStorage, 
+                           Word* transmittedStorage, 
+                           unsigned int length):
+                clock(recorderClock),
+                frozen(false),
+                received(receivedStorage, length),
+                transmitted(transmittedStorage, length){};
+
+            void recordReceived(Byte byte)
+            {
+                if (!frozen) received.record(byte, clock());
+            }
+
+            void recordTransmitted(Byte byte)
+            {
+                if (!frozen) transmitted.record(byte, clock());
+            }
+
+            /**
+             * @brief Stop recording.  Safe to call from any context, 
+             *        including fault handlers.
+             */
+            void freeze(){ frozen = true; };
+
+            void resume(){ frozen = false; };
+
+            bool isFrozen() const { return frozen; };
+
+            /**
+             * @brief Discard everything recorded.  Only safe while frozen.
+             */
+            void clear()
+            {
+                received.clear();
+                transmitted.clear();
+            }
+
+            const FlightTrack& getReceived() const { return received; };
+
+            const FlightTrack& getTransmitted() const { return transmitted; };
+
+            /**
+             * @brief Freeze the recorder and write its contents.  Allocates 
+             *        nothing, so it can be called from a fault handler.
+             * 
+             * @param writer The destination
+             * @param ticksPerSecond The clock rate, stored in the dump
+             * @return False if the writer failed
+             */
+            bool dump(FlightDumpWriter& writer, uint32_t ticksPerSecond = 0);
+        protected:
+            Clock clock;
+            volatile bool frozen;
+            FlightTrack received;
+            FlightTrack transmitted;
+
+            static bool dumpTrack(FlightDumpWriter& writer, const FlightTrack& track);
+    };
+
+    /**
+     * @brief FlightRecorder with its own storage.
+     * 
+     * @tparam LENGTH The bytes kept in each direction, a power of two
+     */
+    template<unsigned int LENGTH>
+    class StaticFlightRecorder: public FlightRecorder 
+    {
+        static_assert(LENGTH && !(LENGTH & (LENGTH - 1)), 
+                      "StaticFlightRecorder LENGTH must be a power of two");
+        public:
+            StaticFlightRecorder(Clock recorderClock): 
+                FlightRecorder(recorderClock, receivedStorage, 
+                               transmittedStorage, LENGTH){};
+        protected:
+            Word receivedStorage[LENGTH];
+            Word transmittedStorage[LENGTH];
+    };
+}
+
+#endif
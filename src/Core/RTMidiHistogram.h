@@ -0,0 +1,257 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHistogram.h 
+//!  @brief Fixed memory log-linear histogram
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_HISTOGRAM_H_
+#define _RT_MIDI_CORE_HISTOGRAM_H_
+
+#include "./RTMidiDependencies.h"
+#include "./RTMidiCoreTypes.h"
+#include "./RTMidiAtomic.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Percentiles read from a histogram.
+     */
+    struct HistogramSummary 
+    {
+        uint32_t count;
+        Word p50;
+        Word p99;
+        Word p999;
+        Word max;
+    };
+
+    /**
+     * @brief Fixed memory histogram with log-linear buckets, in the style 
+     *        of HDR histograms.
+     * 
+     *        Values below 2 * 2^SUB_BITS each have their own bucket.  Above 
+     *        that, every power of two range is split into 2^SUB_BITS 
+     *        buckets, so a value is reported to within 1 / 2^SUB_BITS of 
+     *        itself.  Values of 2^MAX_BITS and above are counted in the 
+     *        last bucket, but the exact maximum is still kept.
+     * 
+     *        record() is a bucket lookup and an atomic increment, so it 
+     *        can be called from an interrupt, and from several contexts at 
+     *        once.  summarize() can be called from any other context while 
+     *        recording continues.  On targets without atomic read-modify-
+     *        write (RTMIDI_ATOMIC_RMW is 0) the increment is a plain load 
+     *        and store, so a count can be lost if record() is preempted by 
+     *        another record() into the same histogram.
+     * 
+     * @tparam SUB_BITS The bits of resolution within each power of two
+     * @tparam MAX_BITS The bits in the largest value bucketed exactly
+     */
+    template<unsigned int SUB_BITS = 3, unsigned int MAX_BITS = 20>
+    class LogLinearHistogram 
+    {
+        static_assert(SUB_BITS < MAX_BITS && MAX_BITS <= 32, 
+                      "LogLinearHistogram needs SUB_BITS < MAX_BITS <= 32");
+        public:
+            static constexpr unsigned int SubBuckets = 1u << SUB_BITS;
+            static constexpr unsigned int BucketCount = 
+                (MAX_BITS - SUB_BITS + 1) * SubBuckets;
+            static constexpr Word Largest = 
+                (MAX_BITS < 32) ? ((1u << (MAX_BITS % 32)) - 1) : 0xFFFFFFFFu;
+
+            LogLinearHistogram(){ reset(); };
+
+            /**
+             * @brief Get the bucket a value is counted in.
+             */
+            static unsigned int bucketOf(Word value)
+            {
+                if (value < SubBuckets) return value;
+                if (value > Largest) return BucketCount - 1;
+                unsigned int msb = 31 - __builtin_clz(value);
+                unsigned int shift = msb - SUB_BITS;
+                return ((shift + 1) << SUB_BITS) + (value >> shift) - SubBuckets;
+            }
+
+            /**
+             * @brief Get the largest value counted in a bucket.
+             */
+            static Word bucketLimit(unsigned int bucket)
+            {
+                unsigned int group = bucket >> SUB_BITS;
+                unsigned int sub = bucket & (SubBuckets - 1);
+                if (group == 0) return sub;
+                unsigned int shift = group - 1;
+                return (static_cast<Word>(SubBuckets + sub) << shift) + 
+                       ((static_cast<Word>(1) << shift) - 1);
+            }
+
+            /**
+             * @brief Count a value.
+             */
+            void record(Word value)
+            {
+                counts[bucketOf(value)].fetchAdd(1);
+                Word largest = maximum.loadRelaxed();
+                while ((value > largest) && 
+                       !maximum.compareExchange(largest, value)){};
+            }
+
+            /**
+             * @brief Clear the histogram.  Only safe from the recording 
+             *        context, or while nothing is recorded.
+             */
+            void reset()
+            {
+                for (unsigned int i = 0; i < BucketCount; i++) 
+                {
+                    counts[i].storeRelaxed(0);
+                }
+                maximum.storeRelaxed(0);
+            }
+
+            /**
+             * @brief Get the total number of values counted.
+             */
+            uint32_t count() const 
+            {
+                uint32_t total = 0;
+                for (unsigned int i = 0; i < BucketCount; i++) 
+                {
+                    total += counts[i].loadRelaxed();
+                }
+                return total;
+            }
+
+            Word max() const { return maximum.loadRelaxed(); };
+
+            /**
+             * @brief Get the value below or at which a fraction of the 
+             *        values lie.
+             * 
+             * @param partsPerMillion The fraction, e.g. 990000 for p99
+             * @return The upper limit of the bucket holding that value, or 0 
+             *         if nothing was counted
+             */
+            Word valueAt(uint32_t partsPerMillion) const 
+            {
+                uint32_t total = count();
+                if (total == 0) return 0;
+                uint32_t rank = rankOf(total, partsPerMillion);
+                uint32_t seen = 0;
+                for (unsigned int i = 0; i < BucketCount; i++)
+                {
+                    seen += counts[i].loadRelaxed();
+                    if (seen >= rank) return limitAt(i);
+                }
+                return max();
+            }
+
+            /**
+             * @brief Read the count, p50, p99, p99.9 and maximum in one pass.  
+             *        Values recorded during the call may or may not be 
+             *        included.
+             */
+            HistogramSummary summarize() const 
+            {
+                HistogramSummary summary;
+                summary.max = max();
+                summary.count = count();
+                summary.p50 = summary.p99 = summary.p999 = 0;
+                if (summary.count == 0) return summary;
+
+                uint32_t rank50 = rankOf(summary.count, 500000);
+                uint32_t rank99 = rankOf(summary.count, 990000);
+                uint32_t rank999 = rankOf(summary.count, 999000);
+                uint32_t seen = 0;
+                summary.p50 = summary.p99 = summary.p999 = summary.max;
+                for (unsigned int i = 0; i < BucketCount; i++)
+                {
+                    uint32_t previous = seen;
+                    seen += counts[i].loadRelaxed();
+                    if (seen == previous) continue;
+                    if ((previous < rank50) && (seen >= rank50)) summary.p50 = limitAt(i);
+                    if ((previous < rank99) && (seen >= rank99)) summary.p99 = limitAt(i);
+                    if (seen >= rank999) 
+                    {
+                        summary.p999 = limitAt(i);
+                        break;
+                    }
+                }
+                return summary;
+            }
+        protected:
+            Atomic<uint32_t> counts[BucketCount];
+            Atomic<Word> maximum;
+
+            static uint32_t rankOf(uint32_t total, uint32_t partsPerMillion)
+            {
+                uint64_t rank = (static_cast<uint64_t>(total) * partsPerMillion 
+                                 + 999999) / 1000000;
+                return rank ? static_cast<uint32_t>(rank) : 1;
+            }
+
+            //A bucket's limit, but never more than the largest value seen
+            Word limitAt(unsigned int bucket) const 
+            {
+                Word limit = bucketLimit(bucket);
+                Word largest = max();
+                return (limit > largest) ? largest : limit;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,181 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiLatencyMonitor.h 
+//!  @brief Latency histograms for each stage of the receive to transmit path
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_LATENCY_MONITOR_H_
+#define _RT_MIDI_CORE_LATENCY_MONITOR_H_
+
+#include "./RTMidiDependencies.h"
+#include "./RTMidiCoreTypes.h"
+#include "./RTMidiHistogram.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The stages of the receive to transmit path that latency 
+     *        probes measure.
+     */
+    enum class LatencyStage: Byte 
+    {
+        //First byte of a message received to the message parsed
+        Parse = 0,
+        //Message parsed to taken from the buffer by processMessages()
+        Queue = 1,
+        //Message taken from the buffer to its listeners returning
+        Listener = 2,
+        //Message queued with sendMessage() to its first byte transmitted
+        TransmitQueue = 3,
+        //Message queued for thru to its first byte transmitted
+        ThruQueue = 4
+    };
+
+    constexpr unsigned int LatencyStageCount = 5;
+
+    /**
+     * @brief The histogram kept for each stage.  With the clock in 
+     *        microseconds it covers about a second to within 1/8.
+     */
+    typedef LogLinearHistogram<3, 20> LatencyHistogram;
+
+    /**
+     * @brief Collects the latency of each LatencyStage.
+     * 
+     *        The probes are compiled in when RTMIDI_ENABLE_LATENCY_PROBES 
+     *        is 1, and record into the monitor passed to attach().  Times 
+     *        come from the monitor's clock, in any units, though it must 
+     *        wrap at 2^32 like Word.  A start time of 0 means the start was 
+     *        not stamped, so that sample is skipped.
+     * 
+     *        There is one active monitor shared by every device, so a 
+     *        stage may be recorded from several contexts at once, such as 
+     *        the receive interrupts of two ports or PortScheduler workers.  
+     *        Recording uses atomic increments rather than locks, so it is 
+     *        safe from all of them, except on targets without atomic read-
+     *        modify-write (see LogLinearHistogram), where a sample may be 
+     *        lost when two recording contexts preempt each other.  
+     *        summary() can be called from the main loop or another thread 
+     *        at any time.
+     */
+    class LatencyMonitor 
+    {
+        public:
+            typedef Word (*Clock)();
+
+            LatencyMonitor(Clock monitorClock): clock(monitorClock){};
+
+            /**
+             * @brief Make this the monitor that the probes record into.
+             * 
+             * @param monitor The monitor, or nullptr to stop recording
+             */
+            static void attach(LatencyMonitor* monitor){ active = monitor; };
+
+            static LatencyMonitor* getActive(){ return active; };
+
+            /**
+             * @brief Read the active monitor's clock.
+             * 
+             * @return The time, or 0 if no monitor is attached
+             */
+            static Word now()
+            {
+                LatencyMonitor* monitor = active;
+                return monitor ? monitor->clock() : 0;
+            }
+
+            /**
+             * @brief Record a stage that started at startTime and ends now.
+             * 
+             * @return The end time, or 0 if nothing was recorded
+             */
+            static Word record(LatencyStage stage, Word startTime)
+            {
+                LatencyMonitor* monitor = active;
+                if (!monitor || (startTime == 0)) return 0;
+                Word endTime = monitor->clock();
+                monitor->histograms[static_cast<Byte>(stage)].record(endTime - startTime);
+                return endTime;
+            }
+
+            /**
+             * @brief Get a stage's count, p50, p99, p99.9 and maximum.
+             */
+            HistogramSummary summary(LatencyStage stage) const 
+            {
+                return histograms[static_cast<Byte>(stage)].summarize();
+            }
+
+            const LatencyHistogram& getHistogram(LatencyStage stage) const 
+            {
+                return histograms[static_cast<Byte>(stage)];
+            }
+
+            /**
+             * @brief Clear every stage.  Only safe while nothing is being 
+             *        recorded.
+             */
+            void reset();
+        protected:
+            static LatencyMonitor* volatile active;
+            Clock clock;
+            LatencyHistogram histograms[LatencyStageCount];
+    };
+}
+
+#endif
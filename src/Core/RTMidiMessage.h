@@ -88,27 +88,26 @@ namespace RTMIDI
              *          Static Methods          *
              ************************************/
 
-            static Message createChannelMessage(Channel ch, StatusCode status, 
+            static constexpr Message createChannelMessage(Channel ch, StatusCode status, 
                                                 DataByte data0 = DataByte::Invalid, 
                                                 DataByte data1 = DataByte::Invalid)
             {
-                StatusByte newStatus(status, ch);
-                return Message(newStatus, data0, data1);
+                return Message(StatusByte(status, ch), data0, data1);
             };
 
-            static Message createProgramChange(Channel ch, DataByte no)
+            static constexpr Message createProgramChange(Channel ch, DataByte no)
             {
                 return createChannelMessage(ch, StatusCode::ProgramChange, no);
             };
 
-            static Message createControlChange(Channel ch, DataByte no, 
+            static constexpr Message createControlChange(Channel ch, DataByte no, 
                                                DataByte value)
             {
                 return createChannelMessage(ch, StatusCode::ControlChange, 
                                             no, value);
             };
 
-            static Message invalid()
+            static constexpr Message invalid()
             {
                 return Message();
             }
@@ -116,32 +115,32 @@ namespace RTMIDI
              *          Constructors            *
              ************************************/
 
-            Message(): Message(DataByte::Invalid, 
+            constexpr Message(): Message(DataByte::Invalid, 
                                DataByte::Invalid, 
                                DataByte::Invalid){};
 
-            Message(SystemCommonCode code, 
+            constexpr Message(SystemCommonCode code, 
                     DataByte data0 = DataByte::Invalid, 
                     DataByte data1 = DataByte::Invalid):
                         Message(StatusByte(code), data0, data1){};
 
-            Message(StatusByte status):
+            constexpr Message(StatusByte status):
                 Message(static_cast<Byte>(status), 
                         DataByte::Invalid, 
                         DataByte::Invalid){};
 
-            Message(StatusByte status, DataByte data):
+            constexpr Message(StatusByte status, DataByte data):
                 Message(static_cast<Byte>(status), 
                         static_cast<Byte>(data), 
                         DataByte::Invalid){};
 
-            Message(StatusByte status, DataByte data0, DataByte data1):
+            constexpr Message(StatusByte status, DataByte data0, DataByte data1):
                 Message(static_cast<Byte>(status), 
                         static_cast<Byte>(data0), 
                         static_cast<Byte>(data1)){};
 
-            Message(Byte status, Byte data0, Byte data1 = DataByte::Invalid): 
-                msg{ .byte={status, data0, data1, 0x0}}{};
+            constexpr Message(Byte status, Byte data0, Byte data1 = DataByte::Invalid): 
+                msg{{status, data0, data1, 0x0}}{};
 
             Message(Word dataWord):
                 msg{ .word=dataWord }{};
@@ -159,9 +158,9 @@ namespace RTMIDI
              * 
              * @return This messages Status Byte 
              */
-            StatusByte getStatus() const 
+            constexpr StatusByte getStatus() const 
             {
-                return StatusByte(msg.items.status);
+                return StatusByte(msg.byte[0]);
             }
 
             /**
@@ -174,9 +173,9 @@ namespace RTMIDI
              * @param index The byte index to retrieve (0 or 1)
              * @return The requested data byte 
              */
-            DataByte getDataByte(Byte index) const 
+            constexpr DataByte getDataByte(Byte index) const 
             {
-                return DataByte(msg.items.data[index & 0x1]);
+                return DataByte(msg.byte[1 + (index & 0x1)]);
             }
 
             /**
@@ -184,9 +183,9 @@ namespace RTMIDI
              * 
              * @return This message's first data byte 
              */
-            DataByte getFirstDataByte() const 
+            constexpr DataByte getFirstDataByte() const 
             {
-                return DataByte(msg.items.data[0]);
+                return DataByte(msg.byte[1]);
             }
 
             /**
@@ -194,9 +193,9 @@ namespace RTMIDI
              * 
              * @return This message's second data byte 
              */
-            DataByte getSecondDataByte() const 
+            constexpr DataByte getSecondDataByte() const 
             {
-                return DataByte(msg.items.data[1]);
+                return DataByte(msg.byte[2]);
             }
 
             /**
@@ -246,17 +245,29 @@ namespace RTMIDI
              * 
              * @return True is valid, false if not.
              */
-            bool isValid() const 
+            constexpr bool isValid() const 
             {
                 return getStatus().isValid();
             }
 
-            Byte byteLength() const 
+            constexpr Byte byteLength() const 
             {
-                if (msg.items.data[1] != DataByte::Invalid) return 3;
-                else if (msg.items.data[0] != DataByte::Invalid) return 2;
-                else if (msg.items.status != DataByte::Invalid) return 1;
-                else return 0;
+                return (msg.byte[2] != DataByte::Invalid) ? 3 : 
+                       (msg.byte[1] != DataByte::Invalid) ? 2 : 
+                       (msg.byte[0] != DataByte::Invalid) ? 1 : 0;
+            }
+
+            /**
+             * @brief Check this is a complete message that can be sent as 
+             *        it is: a status byte that starts a message by itself, 
+             *        followed by exactly the data bytes it needs.
+             */
+            constexpr bool isWellFormed() const 
+            {
+                return (getStatus().messageLength() != 0) && 
+                       (byteLength() == getStatus().messageLength()) && 
+                       ((byteLength() < 2) || DataByte::isDataByte(msg.byte[1])) && 
+                       ((byteLength() < 3) || DataByte::isDataByte(msg.byte[2]));
             }
 
             void setChannel(Channel ch)
@@ -274,6 +285,17 @@ namespace RTMIDI
                 msg.items.status = static_cast<Byte>(status);
             }
 
+            /**
+             * @brief Set one of the MIDI Message's data bytes
+             * 
+             * @param index The byte index to set (0 or 1)
+             * @param data The new data byte
+             */
+            void setDataByte(Byte index, DataByte data)
+            {
+                msg.items.data[index & 0x1] = static_cast<Byte>(data);
+            }
+
             /**
              * @brief  Operator overload allowing this class to be implicitly
              *         cast to its underlying data structure.
@@ -296,7 +318,7 @@ namespace RTMIDI
                 return msg.word;
             }
 
-            Byte getByte(unsigned int index) const
+            constexpr Byte getByte(unsigned int index) const
             {
                 return msg.byte[index % 4];
             }
@@ -63,6 +63,9 @@
 
 #include "./RTMidiRingBuffer.h"
 #include "./RTMidiMessage.h"
+#include "./RTMidiBufferNotifier.h"
+#include "./RTMidiLatencyMonitor.h"
+#include "./RTMidiTelemetry.h"
 
 namespace RTMIDI 
 {
@@ -73,7 +76,110 @@ namespace RTMIDI
             /**
              * @brief Construct a new empty MessageBuffer
              */
-            MessageBuffer(): RingBuffer<Message, LENGTH, INDEX_TYPE>(){};
+            MessageBuffer(): RingBuffer<Message, LENGTH, INDEX_TYPE>(), 
+                             notifier(nullptr){};
+
+            /**
+             * @brief Attach a notifier that is woken when the buffer goes 
+             *        from empty to not empty.
+             * 
+             * @param bufferNotifier The notifier, or nullptr to detach
+             */
+            void setNotifier(BufferNotifier* bufferNotifier)
+            {
+                notifier = bufferNotifier;
+            }
+
+            BufferNotifier* getNotifier() const { return notifier; };
+
+            /**
+             * @brief Adds an item to the head of the buffer, notifying the 
+             *        consumer if the buffer was empty.
+             * 
+             * @param item The item to add.
+             * @return False if the buffer was full and the item was dropped
+             */
+            bool push(Message item)
+            {
+                INDEX_TYPE slot = this->head;
+            #if RTMIDI_ENABLE_LATENCY_PROBES
+                //Written before the push publishes the slot
+                stamps[slot] = LatencyMonitor::now();
+            #endif
+                RingBuffer<Message, LENGTH, INDEX_TYPE>::push(item);
+                bool stored = (this->head != slot);
+            #if RTMIDI_ENABLE_TELEMETRY
+                telemetry.beginWrite();
+                if (stored) telemetry.raise(BufferTelemetry::HighWatermark, 
+                                            this->available());
+                else telemetry.add(BufferTelemetry::Drops);
+                telemetry.endWrite();
+            #endif
+                if (!notifier || !stored) return stored;
+                //Pairs with the fence in hasItems(): either the consumer 
+                //sees the new head, or this sees that it had taken every 
+                //item before this one and may be asleep
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                if (this->loadTail() == slot) notifier->notify();
+                return true;
+            }
+
+            bool store(Message item){ return push(item); };
+
+            /**
+             * @brief Remove the item at the tail of the buffer.  When 
+             *        latency probes are enabled, the time it spent in the 
+             *        buffer is recorded as a latency stage.
+             * 
+             * @param stage The stage the time in this buffer belongs to
+             * @return The item, or an invalid message if the buffer is empty
+             */
+            Message popTimed(LatencyStage stage)
+            {
+            #if RTMIDI_ENABLE_LATENCY_PROBES
+                if (!this->available()) return Message();
+                //Read after available() has acquired the producer's writes 
+                //and before the pop frees the slot
+                Word stamp = stamps[this->tail];
+                Message item = RingBuffer<Message, LENGTH, INDEX_TYPE>::pop();
+                LatencyMonitor::record(stage, stamp);
+                return item;
+            #else
+                return RingBuffer<Message, LENGTH, INDEX_TYPE>::pop();
+            #endif
+            }
+
+            /**
+             * @brief Check whether there are items to read, ordered after 
+             *        the reads that emptied the buffer.  Consumers call this 
+             *        before deciding to wait on the notifier.
+             */
+            bool hasItems()
+            {
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                return this->available() > 0;
+            }
+
+            /**
+             * @brief Add this buffer's drops and high watermark to a 
+             *        snapshot.  Nothing is added unless 
+             *        RTMIDI_ENABLE_TELEMETRY is 1.
+             */
+            void readTelemetry(DeviceTelemetry& snapshot) const 
+            {
+            #if RTMIDI_ENABLE_TELEMETRY
+                telemetry.readInto(snapshot);
+            #endif
+            }
+        protected:
+            BufferNotifier* notifier;
+        #if RTMIDI_ENABLE_TELEMETRY
+            BufferTelemetry telemetry;
+        #endif
+        #if RTMIDI_ENABLE_LATENCY_PROBES
+            //The time each item was pushed
+            Word stamps[LENGTH];
+        #endif
     };
 }
-#endif
\ No newline at end of file
+#endif
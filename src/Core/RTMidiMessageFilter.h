@@ -0,0 +1,150 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiMessageFilter.h 
+//!  @brief RTMIDI MessageFilter class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_MESSAGE_FILTER_H_
+#define _RT_MIDI_CORE_MESSAGE_FILTER_H_
+
+#include "./RTMidiMessage.h"
+
+namespace RTMIDI 
+{
+    typedef uint16_t MessageTypeMask;
+    typedef uint16_t ChannelMask;
+
+    /**
+     * @brief Bits identifying message types in a MessageTypeMask.
+     */
+    enum MessageType: MessageTypeMask
+    {
+        TypeNoteOff = 0x0001,
+        TypeNoteOn = 0x0002,
+        TypePolyphonicKeyPressure = 0x0004,
+        TypeControlChange = 0x0008,
+        TypeProgramChange = 0x0010,
+        TypeChannelPressure = 0x0020,
+        TypePitchBend = 0x0040,
+        TypeSystemCommon = 0x0080,
+        TypeSystemRealtime = 0x0100,
+        TypeNotes = 0x0003,
+        TypeChannelVoice = 0x007F,
+        TypeAll = 0x01FF
+    };
+
+    constexpr ChannelMask AllChannels = 0xFFFF;
+
+    /**
+     * @brief Matches messages by type and MIDI channel.
+     * 
+     *        The channel mask only applies to channel voice messages; 
+     *        system messages are matched on type alone.
+     */
+    class MessageFilter 
+    {
+        public:
+            /**
+             * @brief Get the MessageType bit for a status byte, or 0 if 
+             *        the byte is not a status byte.
+             */
+            static constexpr MessageTypeMask typeBit(Byte status)
+            {
+                return (status < StatusByte::Min) ? 0 :
+                       (status < StatusByte::SystemCommonMin) ? 
+                            static_cast<MessageTypeMask>(1u << ((status >> 4) - 8)) :
+                       (status < StatusByte::SystemRealtimeMin) ? 
+                            static_cast<MessageTypeMask>(TypeSystemCommon) : 
+                            static_cast<MessageTypeMask>(TypeSystemRealtime);
+            }
+
+            /**
+             * @brief Get the ChannelMask bit for a channel, or 0 if the 
+             *        channel is not Ch0 - Ch15.
+             */
+            static constexpr ChannelMask channelBit(Channel ch)
+            {
+                return (ch <= Ch15) ? (1u << ch) : 0;
+            }
+
+            static constexpr bool matches(MessageTypeMask types, 
+                                          ChannelMask channels, 
+                                          Byte status)
+            {
+                return ((types & typeBit(status)) != 0) && 
+                       ((status >= StatusByte::SystemCommonMin) || 
+                        ((channels & (1u << (status & 0x0F))) != 0));
+            }
+
+            constexpr MessageFilter(MessageTypeMask filterTypes = TypeAll, 
+                                    ChannelMask filterChannels = AllChannels):
+                types(filterTypes), channels(filterChannels){};
+
+            bool matches(Message msg) const 
+            {
+                return matches(types, channels, msg.getStatus());
+            }
+
+            MessageTypeMask getTypes() const { return types; };
+
+            ChannelMask getChannels() const { return channels; };
+        protected:
+            MessageTypeMask types;
+            ChannelMask channels;
+    };
+}
+#endif
@@ -0,0 +1,300 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiMessageSequence.h 
+//!  @brief Message sequences serialised at compile time
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_MESSAGE_SEQUENCE_H_
+#define _RT_MIDI_CORE_MESSAGE_SEQUENCE_H_
+
+#include "./RTMidiDependencies.h"
+#include "./RTMidiCoreTypes.h"
+#include "./RTMidiStatusByte.h"
+#include "./RTMidiMessage.h"
+#include "./RTMidiIndexSequence.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief One entry of a MessageSequence: a message, or a SysEx given 
+     *        as its data bytes without the F0 and F7.
+     */
+    class SequenceEvent 
+    {
+        public:
+            constexpr SequenceEvent(Message msg): 
+                message(msg), sysExData(nullptr), sysExLength(0){};
+
+            /**
+             * @brief Make a SysEx event.  The data must have static 
+             *        storage duration, such as a constexpr array at 
+             *        namespace scope.
+             */
+            template<unsigned int LENGTH>
+            static constexpr SequenceEvent sysEx(const Byte (&data)[LENGTH])
+            {
+                return SequenceEvent(data, LENGTH);
+            }
+
+            constexpr bool isSysEx() const { return sysExData != nullptr; };
+
+            constexpr Message getMessage() const { return message; };
+
+            /**
+             * @brief Check the event can be sent as it is.
+             */
+            constexpr bool isValid() const 
+            {
+                return isSysEx() ? allDataBytes(0) : message.isWellFormed();
+            }
+
+            /**
+             * @brief Get the running status after this event is sent.
+             * 
+             * @param status The running status before it is sent
+             */
+            constexpr Byte runningStatusAfter(Byte status) const 
+            {
+                return isSysEx() ? 0 : 
+                       message.getStatus().isChannelVoice() ? message.getByte(0) : 
+                       message.getStatus().isSystemRealtime() ? status : 0;
+            }
+
+            /**
+             * @brief Get the number of bytes sent for this event.
+             * 
+             * @param status The running status before it is sent
+             */
+            constexpr unsigned int serialisedLength(Byte status) const 
+            {
+                return isSysEx() ? (sysExLength + 2) : 
+                       (message.byteLength() - (runningStatusHit(status) ? 1 : 0));
+            }
+
+            /**
+             * @brief Get one of the bytes sent for this event.
+             * 
+             * @param status The running status before it is sent
+             * @param index The byte, less than serialisedLength(status)
+             */
+            constexpr Byte serialisedByte(Byte status, unsigned int index) const 
+            {
+                return !isSysEx() ? message.getByte(index + (runningStatusHit(status) ? 1 : 0)) : 
+                       (index == 0) ? 0xF0 : 
+                       (index <= sysExLength) ? sysExData[index - 1] : 0xF7;
+            }
+        protected:
+            Message message;
+            const Byte* sysExData;
+            unsigned int sysExLength;
+
+            constexpr SequenceEvent(const Byte* data, unsigned int length): 
+                message(), sysExData(data), sysExLength(length){};
+
+            constexpr bool runningStatusHit(Byte status) const 
+            {
+                return message.getStatus().isChannelVoice() && 
+                       (message.getByte(0) == status);
+            }
+
+            constexpr bool allDataBytes(unsigned int index) const 
+            {
+                return (index == sysExLength) || 
+                       (DataByte::isDataByte(sysExData[index]) && allDataBytes(index + 1));
+            }
+    };
+
+    /**
+     * @brief The Universal SysEx data for General MIDI System On (a GM 
+     *        reset), for use with SequenceEvent::sysEx().
+     */
+    constexpr Byte GeneralMidiSystemOn[] = {0x7E, 0x7F, 0x09, 0x01};
+
+    /**
+     * @brief Compile time helpers for serialising an array of 
+     *        SequenceEvents.  The functions recurse once per event, so a 
+     *        sequence is limited to a few hundred events by the compiler's 
+     *        constexpr depth.
+     */
+    struct SequenceSerialiser 
+    {
+        template<unsigned int COUNT>
+        static constexpr unsigned int length(const SequenceEvent (&events)[COUNT], 
+                                             unsigned int index = 0, 
+                                             Byte status = 0)
+        {
+            return (index == COUNT) ? 0 : 
+                events[index].serialisedLength(status) + 
+                length(events, index + 1, events[index].runningStatusAfter(status));
+        }
+
+        template<unsigned int COUNT>
+        static constexpr Byte byteAt(const SequenceEvent (&events)[COUNT], 
+                                     unsigned int offset, 
+                                     unsigned int index = 0, 
+                                     Byte status = 0)
+        {
+            return (offset < events[index].serialisedLength(status)) ? 
+                events[index].serialisedByte(status, offset) : 
+                byteAt(events, offset - events[index].serialisedLength(status), 
+                       index + 1, events[index].runningStatusAfter(status));
+        }
+
+        /**
+         * @brief Get the index of the first event that is not valid.
+         * 
+         * @return The index, or COUNT if every event is valid
+         */
+        template<unsigned int COUNT>
+        static constexpr unsigned int firstInvalid(const SequenceEvent (&events)[COUNT], 
+                                                   unsigned int index = 0)
+        {
+            return (index == COUNT) ? COUNT : 
+                   !events[index].isValid() ? index : 
+                   firstInvalid(events, index + 1);
+        }
+
+        template<unsigned int COUNT>
+        static constexpr unsigned int count(const SequenceEvent (&)[COUNT])
+        {
+            return COUNT;
+        }
+    };
+
+    /**
+     * @brief The bytes of a MessageSequence as a value type.
+     */
+    template<unsigned int LENGTH>
+    struct SequenceImage 
+    {
+        Byte data[LENGTH];
+    };
+
+    /**
+     * @brief A sequence of messages serialised at compile time into a 
+     *        constant byte array, with running status applied, so that it 
+     *        is stored in flash rather than built in RAM at start up.  The 
+     *        events array is only needed at compile time, so it is left 
+     *        out of the image when unused sections are removed.
+     * 
+     *        SEQUENCE must have a static constexpr array of SequenceEvents 
+     *        called events.  Every event is checked with a static_assert.
+     * 
+     *          struct StartupSequence 
+     *          {
+     *              static constexpr SequenceEvent events[] = {
+     *                  SequenceEvent::sysEx(GeneralMidiSystemOn),
+     *                  Message::createProgramChange(Ch0, 19),
+     *                  Message::createControlChange(Ch0, 7, 100),
+     *                  Message::createControlChange(Ch0, 10, 64)
+     *              };
+     *          };
+     *          constexpr SequenceEvent StartupSequence::events[];
+     * 
+     *          typedef MessageSequence<StartupSequence> Startup;
+     *          output.sendBytes(Startup::bytes, Startup::length);
+     * 
+     *        On AVR constant data is copied to RAM at start up unless it is 
+     *        PROGMEM, and GCC ignores section attributes on the static 
+     *        members of a template, so bytes uses RAM there.  Keep the 
+     *        sequence in flash by storing its image in a variable of your 
+     *        own at namespace scope, and send that with sendFlashBytes():
+     * 
+     *          constexpr Startup::Image StartupImage RTMIDI_PROGMEM = 
+     *              Startup::image();
+     *          output.sendFlashBytes(StartupImage.data, Startup::length);
+     * 
+     * @tparam SEQUENCE The class holding the events
+     */
+    template<class SEQUENCE, 
+             class INDICES = MakeIndexSequence<SequenceSerialiser::length(SEQUENCE::events)>>
+    struct MessageSequence;
+
+    template<class SEQUENCE, unsigned int... INDICES>
+    struct MessageSequence<SEQUENCE, IndexSequence<INDICES...>>
+    {
+        static_assert(SequenceSerialiser::firstInvalid(SEQUENCE::events) == 
+                      SequenceSerialiser::count(SEQUENCE::events), 
+                      "MessageSequence events must be complete MIDI messages "
+                      "or SysEx data bytes");
+        static_assert(sizeof...(INDICES) > 0, "MessageSequence must not be empty");
+
+        static constexpr unsigned int length = sizeof...(INDICES);
+
+        typedef SequenceImage<sizeof...(INDICES)> Image;
+
+        static constexpr Byte bytes[sizeof...(INDICES)] = 
+            { SequenceSerialiser::byteAt(SEQUENCE::events, INDICES)... };
+
+        /**
+         * @brief Get the bytes as a value, to initialise a variable that 
+         *        is placed in flash with RTMIDI_PROGMEM.
+         */
+        static constexpr Image image()
+        {
+            return Image{{ SequenceSerialiser::byteAt(SEQUENCE::events, INDICES)... }};
+        }
+    };
+
+    template<class SEQUENCE, unsigned int... INDICES>
+    constexpr unsigned int MessageSequence<SEQUENCE, IndexSequence<INDICES...>>::length;
+
+    template<class SEQUENCE, unsigned int... INDICES>
+    constexpr Byte MessageSequence<SEQUENCE, IndexSequence<INDICES...>>::bytes[];
+}
+
+#endif
@@ -0,0 +1,144 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiMessageSpan.h 
+//!  @brief RTMIDI MessageSpan class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_MESSAGE_SPAN_H_
+#define _RT_MIDI_CORE_MESSAGE_SPAN_H_
+
+#include "./RTMidiMessage.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief A read only view of a contiguous array of messages.
+     * 
+     *        The span does not own the messages, it is only valid for as 
+     *        long as the underlying array is.
+     */
+    class MessageSpan 
+    {
+        public:
+            MessageSpan(): messages(nullptr), length(0){};
+
+            MessageSpan(const Message* spanMessages, unsigned int spanLength):
+                messages(spanMessages), length(spanLength){};
+
+            const Message* begin() const { return messages; };
+
+            const Message* end() const { return messages + length; };
+
+            unsigned int size() const { return length; };
+
+            bool empty() const { return (length == 0); };
+
+            const Message& operator[](unsigned int index) const
+            {
+                return messages[index];
+            }
+
+            /**
+             * @brief Get a span covering part of this span.  The result is 
+             *        truncated to the end of this span.
+             * 
+             * @param start The index of the first message
+             * @param count The number of messages
+             * @return The requested part of this span
+             */
+            MessageSpan subspan(unsigned int start, unsigned int count) const
+            {
+                if (start > length) start = length;
+                if (count > length - start) count = length - start;
+                return MessageSpan(messages + start, count);
+            }
+
+            /**
+             * @brief Get the number of consecutive messages, beginning at 
+             *        start, that share the same status code.
+             * 
+             *        This allows a span to be handled as runs of one 
+             *        message type without changing the message order:
+             * 
+             *          for (unsigned int i = 0; i < span.size(); )
+             *          {
+             *              unsigned int n = span.runLength(i);
+             *              handleRun(span.subspan(i, n));
+             *              i += n;
+             *          }
+             * 
+             * @param start The index of the first message in the run
+             * @return The length of the run, or 0 if start is out of range
+             */
+            unsigned int runLength(unsigned int start) const
+            {
+                if (start >= length) return 0;
+                StatusCode code = messages[start].getStatus().getStatusCode();
+                unsigned int i = start + 1;
+                while ((i < length) && 
+                       (messages[i].getStatus().getStatusCode() == code))
+                {
+                    i++;
+                }
+                return i - start;
+            }
+        protected:
+            const Message* messages;
+            unsigned int length;
+    };
+}
+#endif
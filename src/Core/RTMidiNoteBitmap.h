@@ -0,0 +1,188 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiNoteBitmap.h 
+//!  @brief RTMIDI NoteBitmap class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_NOTE_BITMAP_H_
+#define _RT_MIDI_CORE_NOTE_BITMAP_H_
+
+#include "./RTMidiCoreTypes.h"
+#include "./RTMidiDataByte.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief A set of MIDI note numbers stored as a 128 bit bitmap.
+     * 
+     *        All operations are constant time.  Queries that return a 
+     *        note number return DataByte::Invalid when the set is empty.
+     */
+    class NoteBitmap 
+    {
+        public:
+            static constexpr unsigned int WordCount = 4;
+
+            NoteBitmap(): words{0, 0, 0, 0}{};
+
+            void set(Byte note)
+            {
+                words[(note >> 5) & 0x3] |= bit(note);
+            }
+
+            void clear(Byte note)
+            {
+                words[(note >> 5) & 0x3] &= ~bit(note);
+            }
+
+            void clearAll()
+            {
+                for (unsigned int i = 0; i < WordCount; i++) words[i] = 0;
+            }
+
+            bool test(Byte note) const
+            {
+                return (words[(note >> 5) & 0x3] & bit(note)) != 0;
+            }
+
+            bool any() const
+            {
+                return (words[0] | words[1] | words[2] | words[3]) != 0;
+            }
+
+            /**
+             * @brief Get the number of notes in the set.
+             */
+            unsigned int count() const
+            {
+                unsigned int total = 0;
+                for (unsigned int i = 0; i < WordCount; i++)
+                {
+                    total += __builtin_popcountl(static_cast<unsigned long>(words[i]));
+                }
+                return total;
+            }
+
+            /**
+             * @brief Get the lowest note in the set.
+             */
+            Byte lowest() const
+            {
+                return nextFrom(0);
+            }
+
+            /**
+             * @brief Get the highest note in the set.
+             */
+            Byte highest() const
+            {
+                for (int i = WordCount - 1; i >= 0; i--)
+                {
+                    if (words[i]) return (i << 5) + highestBit(words[i]);
+                }
+                return DataByte::Invalid;
+            }
+
+            /**
+             * @brief Get the lowest note in the set that is greater than or 
+             *        equal to the supplied note.  This allows the set to be 
+             *        iterated with:
+             * 
+             *          for (Byte n = notes.lowest(); n <= DataByte::Max; 
+             *               n = notes.nextFrom(n + 1))
+             * 
+             * @param note The note to start searching from
+             */
+            Byte nextFrom(unsigned int note) const
+            {
+                if (note > DataByte::Max) return DataByte::Invalid;
+                unsigned int i = note >> 5;
+                Word remaining = words[i] & (~static_cast<Word>(0) << (note & 0x1F));
+                while (true)
+                {
+                    if (remaining) return (i << 5) + lowestBit(remaining);
+                    if (++i >= WordCount) return DataByte::Invalid;
+                    remaining = words[i];
+                }
+            }
+
+            Word getWord(unsigned int index) const 
+            {
+                return words[index % WordCount];
+            }
+
+        protected:
+            Word words[WordCount];
+
+            static Word bit(Byte note)
+            {
+                return static_cast<Word>(1) << (note & 0x1F);
+            }
+
+            static Byte lowestBit(Word w)
+            {
+                return __builtin_ctzl(static_cast<unsigned long>(w));
+            }
+
+            static Byte highestBit(Word w)
+            {
+                return (sizeof(unsigned long) * 8 - 1) - 
+                       __builtin_clzl(static_cast<unsigned long>(w));
+            }
+    };
+}
+#endif
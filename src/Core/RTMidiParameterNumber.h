@@ -0,0 +1,142 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiParameterNumber.h 
+//!  @brief RTMIDI ParameterNumber class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_PARAMETER_NUMBER_H_
+#define _RT_MIDI_CORE_PARAMETER_NUMBER_H_
+
+#include "./RTMidiCoreTypes.h"
+#include "./RTMidiDataByte.h"
+
+namespace RTMIDI 
+{
+    enum class ParameterType: Byte
+    {
+        None = 0,
+        Registered = 1,
+        NonRegistered = 2,
+        HighResolutionController = 3
+    };
+
+    /**
+     * @brief Identifies a 14 bit parameter: a registered (RPN) or 
+     *        non-registered (NRPN) parameter number, or a 14 bit 
+     *        controller pair (controller 0-31 with its LSB at 32-63).
+     */
+    class ParameterNumber 
+    {
+        public:
+            static constexpr Word Null = 0x3FFF;
+
+            static ParameterNumber registered(Word number)
+            {
+                return ParameterNumber(ParameterType::Registered, number);
+            }
+
+            static ParameterNumber nonRegistered(Word number)
+            {
+                return ParameterNumber(ParameterType::NonRegistered, number);
+            }
+
+            static ParameterNumber highResolutionController(Byte msbNumber)
+            {
+                return ParameterNumber(ParameterType::HighResolutionController,
+                                       msbNumber & 0x1F);
+            }
+
+            ParameterNumber(): type(ParameterType::None), number(Null){};
+
+            ParameterNumber(ParameterType paramType, Word paramNumber): 
+                type(paramType), number(paramNumber & Null){};
+
+            ParameterType getType() const { return type; };
+
+            Word getNumber() const { return number; };
+
+            Byte msb() const { return (number >> 7) & DataByte::Max; };
+
+            Byte lsb() const { return number & DataByte::Max; };
+
+            /**
+             * @brief Check if this is no parameter, or the RPN/NRPN null 
+             *        parameter (127, 127) which deselects the current 
+             *        parameter.
+             */
+            bool isNull() const
+            {
+                return (type == ParameterType::None) || 
+                       ((type != ParameterType::HighResolutionController) && 
+                        (number == Null));
+            }
+
+            bool operator==(const ParameterNumber& other) const
+            {
+                return (type == other.type) && (number == other.number);
+            }
+
+            bool operator!=(const ParameterNumber& other) const
+            {
+                return !(*this == other);
+            }
+        protected:
+            ParameterType type;
+            Word number;
+    };
+}
+#endif
@@ -154,9 +154,10 @@ namespace RTMIDI
              */
             T pop()
             {
-                if(head == tail) return T();
-                T item = buffer[tail];
-                tail = nextIndex(tail);
+                INDEX_TYPE currentTail = tail;
+                if(loadHead() == currentTail) return T();
+                T item = buffer[currentTail];
+                storeTail(nextIndex(currentTail));
                 return item;
             }
 
@@ -175,11 +176,12 @@ namespace RTMIDI
              */
             void push(T item)
             {
-                INDEX_TYPE nextHead = nextIndex(head);
-                if ( nextHead != tail )
+                INDEX_TYPE currentHead = head;
+                INDEX_TYPE nextHead = nextIndex(currentHead);
+                if ( nextHead != loadTail() )
                 {
-                    buffer[head] = item;
-                    head = nextHead;
+                    buffer[currentHead] = item;
+                    storeHead(nextHead);
                 }
             }
 
@@ -198,8 +200,9 @@ namespace RTMIDI
              */
             T peek()
             {
-                if (tail == head) return T();
-                else return buffer[tail];
+                INDEX_TYPE currentTail = tail;
+                if (currentTail == loadHead()) return T();
+                else return buffer[currentTail];
             }
 
             /**
@@ -210,7 +213,7 @@ namespace RTMIDI
              */
             int available()
             {
-                int difference = head - tail;
+                int difference = loadHead() - loadTail();
                 if (difference < 0) return difference + LENGTH;
                 else return difference;
             }
@@ -223,10 +226,12 @@ namespace RTMIDI
              */
             int freeSpace()
             {
-                if (head >= tail)
-                    return LENGTH - 1 - head + tail;
+                INDEX_TYPE currentHead = loadHead();
+                INDEX_TYPE currentTail = loadTail();
+                if (currentHead >= currentTail)
+                    return LENGTH - 1 - currentHead + currentTail;
                 else
-                    return tail - head - 1;
+                    return currentTail - currentHead - 1;
             }
 
             /**
@@ -239,7 +244,7 @@ namespace RTMIDI
                 //If the index of the next head will match the tail,
                 //then the next item would overwrite the tail of the 
                 //buffer.  This means the buffer is full.
-                return (nextIndex(head) == tail) ? true : false;
+                return (nextIndex(loadHead()) == loadTail()) ? true : false;
             }
 
             /**
@@ -285,6 +290,34 @@ namespace RTMIDI
             {
                 return (current + 1) % LENGTH;
             }
+
+            /*
+             * The buffer is safe for one producer and one consumer running 
+             * in different contexts, or on different cores.  The producer 
+             * publishes an item by storing head after the item (release), 
+             * and the consumer frees a slot by storing tail after reading 
+             * it, so neither can see the other's index change before the 
+             * data it guards.
+             */
+            INDEX_TYPE loadHead() const 
+            {
+                return __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+            }
+
+            INDEX_TYPE loadTail() const 
+            {
+                return __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+            }
+
+            void storeHead(INDEX_TYPE value)
+            {
+                __atomic_store_n(&head, value, __ATOMIC_RELEASE);
+            }
+
+            void storeTail(INDEX_TYPE value)
+            {
+                __atomic_store_n(&tail, value, __ATOMIC_RELEASE);
+            }
     };
 }
 #endif
\ No newline at end of file
@@ -93,7 +93,7 @@ namespace RTMIDI
 
             static constexpr bool isChannelVoice(Byte byte)
             {
-                return (byte >= Min)||(byte < SystemCommonMax);
+                return (byte >= Min) && (byte < SystemCommonMin);
             }
 
             static constexpr bool isSystemRealtime(Byte byte)
@@ -132,74 +132,98 @@ namespace RTMIDI
                 return static_cast<Byte>(sysCommonCode);
             }
 
-            static bool appliesToChannel(Byte status, Channel ch)
+            /**
+             * @brief Get the length of the message a status byte starts, 
+             *        including the status byte.
+             * 
+             * @return The length, or 0 if the status byte does not start a 
+             *         complete message by itself (SysEx, undefined and 
+             *         invalid status bytes)
+             */
+            static constexpr Byte messageLength(Byte byte)
             {
-                Channel statusChannel = getChannel(status);
-                if (statusChannel == ChNone) return false;
-                if (ch == ChOmni) return true;
-                return (ch == getChannel(status));
+                return (byte < Min) ? 0 : 
+                       (byte < 0xC0) ? 3 : 
+                       (byte < 0xE0) ? 2 : 
+                       (byte < 0xF0) ? 3 : 
+                       ((byte == 0xF1) || (byte == 0xF3)) ? 2 : 
+                       (byte == 0xF2) ? 3 : 
+                       (byte == 0xF6) ? 1 : 
+                       ((byte >= SystemRealtimeMin) && (byte != 0xF9) && 
+                        (byte != Invalid)) ? 1 : 0;
+            }
+
+            static constexpr bool appliesToChannel(Byte status, Channel ch)
+            {
+                return (getChannel(status) != ChNone) && 
+                       ((ch == ChOmni) || (ch == getChannel(status)));
             } 
 
             /************************************
              *          Constructors            *
              ************************************/
 
-            StatusByte(Byte byte): DataByte(byte){};
+            constexpr StatusByte(Byte byte): DataByte(byte){};
 
-            StatusByte(StatusCode code, Channel ch): DataByte(populate(code, ch)){};
+            constexpr StatusByte(StatusCode code, Channel ch): DataByte(populate(code, ch)){};
 
-            StatusByte(SystemCommonCode code): DataByte(populate(code)){};
+            constexpr StatusByte(SystemCommonCode code): DataByte(populate(code)){};
 
-            bool isValid() const
+            constexpr bool isValid() const
             {
                 return isValid(c); 
             }
 
-            bool isInvalid() const
+            constexpr bool isInvalid() const
             {
                 return isInvalid(c);
             }
 
-            bool isSystemCommon() const
+            constexpr bool isSystemCommon() const
             {
                 return isSystemCommon(c);
             }
 
-            bool isChannelVoice() const
+            constexpr bool isChannelVoice() const
             {
                 return isChannelVoice(c);
             }
 
-            bool isSystemRealtime() const
+            constexpr bool isSystemRealtime() const
             {
                 return isSystemRealtime(this->c);
             }
 
-            Channel getChannel() const 
+            constexpr Channel getChannel() const 
             {
                 return getChannel(c);
             }
 
-            StatusCode getStatusCode() const 
+            constexpr StatusCode getStatusCode() const 
             {
                 return getStatusCode(c);
             }
 
-            SystemCommonCode getSystemCommonCode() const 
+            constexpr SystemCommonCode getSystemCommonCode() const 
             {
                 return getSystemCommonCode(c);
             }
 
-            bool isSystemCommonCode(SystemCommonCode code) const 
+            constexpr bool isSystemCommonCode(SystemCommonCode code) const 
             {
                 return (c == static_cast<Byte>(code));
             }
 
-            bool appliesToChannel(Channel ch) const 
+            constexpr bool appliesToChannel(Channel ch) const 
             {
                 return appliesToChannel(c, ch);
             }
 
+            constexpr Byte messageLength() const 
+            {
+                return messageLength(c);
+            }
+
             void setChannel(Channel ch)
             {
                 if (isChannelVoice())
@@ -213,9 +237,10 @@ namespace RTMIDI
                 c = static_cast<Byte>(code) | (c & 0x0F);
             }
 
-            StatusByte operator=(SystemCommonCode code)
+            StatusByte& operator=(SystemCommonCode code)
             {
-                return StatusByte(code);
+                c = populate(code);
+                return *this;
             }
         protected:
     };
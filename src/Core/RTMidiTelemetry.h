@@ -0,0 +1,310 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiTelemetry.h 
+//!  @brief Lock-free device telemetry counters with consistent snapshots
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_CORE_TELEMETRY_H_
+#define _RT_MIDI_CORE_TELEMETRY_H_
+
+#include "./RTMidiDependencies.h"
+#include "./RTMidiAtomic.h"
+#include "./RTMidiMessageFilter.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The number of message types counted, one for each bit of 
+     *        MessageTypeMask in TypeAll.
+     */
+    constexpr unsigned int MessageTypeCount = 9;
+
+    /**
+     * @brief Get the index of a status byte's message type, matching the 
+     *        bit order of MessageType.
+     * 
+     * @return The index, or MessageTypeCount for a data byte
+     */
+    inline unsigned int messageTypeIndex(Byte status)
+    {
+        MessageTypeMask bit = MessageFilter::typeBit(status);
+        return bit ? __builtin_ctz(bit) : MessageTypeCount;
+    }
+
+    /**
+     * @brief A snapshot of a device's counters.
+     * 
+     *        Counters are 32 bit and wrap, so take deltas often enough that 
+     *        no counter can wrap twice between two snapshots.
+     */
+    struct DeviceTelemetry 
+    {
+        uint32_t bytesIn;
+        uint32_t bytesOut;
+        //Indexed by messageTypeIndex()
+        uint32_t messagesIn[MessageTypeCount];
+        uint32_t messagesOut[MessageTypeCount];
+        //Messages received without their own status byte
+        uint32_t runningStatusHits;
+        uint32_t sysExBytes;
+        uint32_t realtimeBytes;
+        //Data bytes received with no status to apply them to
+        uint32_t orphanDataBytes;
+        //Undefined status bytes (F4, F5, F9, FD), which the parser drops
+        uint32_t undefinedStatusBytes;
+        //Messages lost because a buffer was full
+        uint32_t bufferDrops;
+        //The fullest any of the device's buffers has been
+        uint32_t bufferHighWatermark;
+
+        void clear()
+        {
+            bytesIn = bytesOut = 0;
+            for (unsigned int i = 0; i < MessageTypeCount; i++)
+            {
+                messagesIn[i] = messagesOut[i] = 0;
+            }
+            runningStatusHits = sysExBytes = realtimeBytes = 0;
+            orphanDataBytes = undefinedStatusBytes = 0;
+            bufferDrops = bufferHighWatermark = 0;
+        }
+
+        /**
+         * @brief Get the counts since an earlier snapshot.  The high 
+         *        watermark is not a count, so the current value is kept.
+         */
+        DeviceTelemetry deltaFrom(const DeviceTelemetry& earlier) const 
+        {
+            DeviceTelemetry delta;
+            delta.bytesIn = bytesIn - earlier.bytesIn;
+            delta.bytesOut = bytesOut - earlier.bytesOut;
+            for (unsigned int i = 0; i < MessageTypeCount; i++)
+            {
+                delta.messagesIn[i] = messagesIn[i] - earlier.messagesIn[i];
+                delta.messagesOut[i] = messagesOut[i] - earlier.messagesOut[i];
+            }
+            delta.runningStatusHits = runningStatusHits - earlier.runningStatusHits;
+            delta.sysExBytes = sysExBytes - earlier.sysExBytes;
+            delta.realtimeBytes = realtimeBytes - earlier.realtimeBytes;
+            delta.orphanDataBytes = orphanDataBytes - earlier.orphanDataBytes;
+            delta.undefinedStatusBytes = undefinedStatusBytes - 
+                                         earlier.undefinedStatusBytes;
+            delta.bufferDrops = bufferDrops - earlier.bufferDrops;
+            delta.bufferHighWatermark = bufferHighWatermark;
+            return delta;
+        }
+    };
+
+    /**
+     * @brief A block of counters with one writer and any number of readers.
+     * 
+     *        Counters are updated with relaxed loads and stores between 
+     *        beginWrite() and endWrite(), so the writer never takes a lock 
+     *        or a read-modify-write.  A sequence number around each update 
+     *        (a seqlock) lets read() retry until it gets a copy of the whole 
+     *        block from between two updates.
+     * 
+     *        Every update must come from one context, such as the receive 
+     *        interrupt.  read() must not be called from a context that can 
+     *        interrupt the writer, because it would wait for the writer 
+     *        forever.
+     * 
+     * @tparam COUNT The number of counters
+     */
+    template<unsigned int COUNT>
+    class TelemetryBlock 
+    {
+        public:
+            TelemetryBlock()
+            {
+                for (unsigned int i = 0; i < COUNT; i++) counts[i].storeRelaxed(0);
+            }
+
+            void beginWrite()
+            {
+                sequence.storeRelaxed(sequence.loadRelaxed() + 1);
+                __atomic_thread_fence(__ATOMIC_RELEASE);
+            }
+
+            void endWrite()
+            {
+                sequence.store(sequence.loadRelaxed() + 1);
+            }
+
+            void add(unsigned int index, uint32_t amount = 1)
+            {
+                counts[index].storeRelaxed(counts[index].loadRelaxed() + amount);
+            }
+
+            /**
+             * @brief Raise a counter to value if it is lower.
+             */
+            void raise(unsigned int index, uint32_t value)
+            {
+                if (value > counts[index].loadRelaxed()) counts[index].storeRelaxed(value);
+            }
+
+            /**
+             * @brief Copy every counter.
+             */
+            void read(uint32_t (&values)[COUNT]) const 
+            {
+                while (true)
+                {
+                    uint32_t before = sequence.load();
+                    if (before & 1) continue;
+                    for (unsigned int i = 0; i < COUNT; i++) 
+                    {
+                        values[i] = counts[i].loadRelaxed();
+                    }
+                    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                    if (sequence.loadRelaxed() == before) return;
+                }
+            }
+        protected:
+            Atomic<uint32_t> sequence;
+            Atomic<uint32_t> counts[COUNT];
+    };
+
+    /**
+     * @brief Counters kept by a parser.
+     */
+    class RxTelemetry: public TelemetryBlock<6 + MessageTypeCount>
+    {
+        public:
+            static constexpr unsigned int Bytes = 0;
+            static constexpr unsigned int RunningStatusHits = 1;
+            static constexpr unsigned int SysExBytes = 2;
+            static constexpr unsigned int RealtimeBytes = 3;
+            static constexpr unsigned int OrphanDataBytes = 4;
+            static constexpr unsigned int UndefinedStatusBytes = 5;
+            static constexpr unsigned int Messages = 6;
+
+            void readInto(DeviceTelemetry& telemetry) const 
+            {
+                uint32_t values[6 + MessageTypeCount];
+                read(values);
+                telemetry.bytesIn += values[Bytes];
+                telemetry.runningStatusHits += values[RunningStatusHits];
+                telemetry.sysExBytes += values[SysExBytes];
+                telemetry.realtimeBytes += values[RealtimeBytes];
+                telemetry.orphanDataBytes += values[OrphanDataBytes];
+                telemetry.undefinedStatusBytes += values[UndefinedStatusBytes];
+                for (unsigned int i = 0; i < MessageTypeCount; i++)
+                {
+                    telemetry.messagesIn[i] += values[Messages + i];
+                }
+            }
+    };
+
+    /**
+     * @brief Counters kept by a transmitter.
+     */
+    class TxTelemetry: public TelemetryBlock<1 + MessageTypeCount>
+    {
+        public:
+            static constexpr unsigned int Bytes = 0;
+            static constexpr unsigned int Messages = 1;
+
+            /**
+             * @brief Count a transmitted byte.  Transmitters always send a 
+             *        status byte, so each status byte is one message.
+             */
+            void countByte(Byte byte)
+            {
+                beginWrite();
+                add(Bytes);
+                unsigned int type = messageTypeIndex(byte);
+                if (type < MessageTypeCount) add(Messages + type);
+                endWrite();
+            }
+
+            void readInto(DeviceTelemetry& telemetry) const 
+            {
+                uint32_t values[1 + MessageTypeCount];
+                read(values);
+                telemetry.bytesOut += values[Bytes];
+                for (unsigned int i = 0; i < MessageTypeCount; i++)
+                {
+                    telemetry.messagesOut[i] += values[Messages + i];
+                }
+            }
+    };
+
+    /**
+     * @brief Counters kept by a message buffer, written by its producer.
+     */
+    class BufferTelemetry: public TelemetryBlock<2>
+    {
+        public:
+            static constexpr unsigned int Drops = 0;
+            static constexpr unsigned int HighWatermark = 1;
+
+            void readInto(DeviceTelemetry& telemetry) const 
+            {
+                uint32_t values[2];
+                read(values);
+                telemetry.bufferDrops += values[Drops];
+                if (values[HighWatermark] > telemetry.bufferHighWatermark)
+                {
+                    telemetry.bufferHighWatermark = values[HighWatermark];
+                }
+            }
+    };
+}
+
+#endif
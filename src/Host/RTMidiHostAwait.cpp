@@ -0,0 +1,318 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostAwait.cpp 
+//!  @brief C++20 coroutine awaitables for messages, SysEx and clock beats
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiHostAwait.h"
+
+#if RTMIDI_HOST_LINUX
+
+using namespace RTMIDI;
+
+FrameAllocator::FrameAllocator(unsigned int size, unsigned int count):
+    freeList(nullptr),
+    available(count)
+{
+    lock.clear();
+    //Round up so that every block stays aligned
+    constexpr unsigned int Align = sizeof(std::max_align_t);
+    unsigned int units = (size + Align - 1) / Align;
+    if (units == 0) units = 1;
+    blockSize = units * Align;
+    storage.reset(new std::max_align_t[units * count]);
+    for (unsigned int i = count; i > 0; i--)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(&storage[(i - 1) * units]);
+        block->next = freeList;
+        freeList = block;
+    }
+}
+
+void* FrameAllocator::allocate(std::size_t size)
+{
+    if (size > blockSize) return nullptr;
+    acquire();
+    FreeBlock* block = freeList;
+    if (block) 
+    {
+        freeList = block->next;
+        available.fetch_sub(1, std::memory_order_relaxed);
+    }
+    release();
+    return block;
+}
+
+void FrameAllocator::deallocate(void* pointer)
+{
+    if (!pointer) return;
+    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+    acquire();
+    block->next = freeList;
+    freeList = block;
+    available.fetch_add(1, std::memory_order_relaxed);
+    release();
+}
+
+void FrameAllocator::acquire()
+{
+    while (lock.test_and_set(std::memory_order_acquire)) 
+    {
+        pollPause(WaitPolicy::BusyPoll);
+    }
+}
+
+void FrameAllocator::release()
+{
+    lock.clear(std::memory_order_release);
+}
+
+#if defined(__cpp_impl_coroutine)
+
+constexpr std::size_t Task::FrameHeader;
+
+void* Task::allocateFrame(std::size_t size, FrameAllocator* allocator)
+{
+    size += FrameHeader;
+    void* block = allocator ? allocator->allocate(size) : 
+                              ::operator new(size, std::nothrow);
+    if (!block) return nullptr;
+    *static_cast<FrameAllocator**>(block) = allocator;
+    return static_cast<unsigned char*>(block) + FrameHeader;
+}
+
+void Task::freeFrame(void* frame)
+{
+    void* block = static_cast<unsigned char*>(frame) - FrameHeader;
+    FrameAllocator* allocator = *static_cast<FrameAllocator**>(block);
+    if (allocator) allocator->deallocate(block);
+    else ::operator delete(block);
+}
+
+void AwaitList::pushList(AwaitNode* first, AwaitNode* last)
+{
+    last->next = nullptr;
+    while (lock.test_and_set(std::memory_order_acquire)) 
+    {
+        pollPause(WaitPolicy::BusyPoll);
+    }
+    if (tail) tail->next = first;
+    else head = first;
+    tail = last;
+    lock.clear(std::memory_order_release);
+}
+
+AwaitNode* AwaitList::takeAll()
+{
+    while (lock.test_and_set(std::memory_order_acquire)) 
+    {
+        pollPause(WaitPolicy::BusyPoll);
+    }
+    AwaitNode* first = head;
+    head = nullptr;
+    tail = nullptr;
+    lock.clear(std::memory_order_release);
+    return first;
+}
+
+void MessageAwaitables::deliverMessage(Message msg)
+{
+    AwaitNode* node = messageWaits.takeAll();
+    AwaitNode* keptFirst = nullptr;
+    AwaitNode* keptLast = nullptr;
+    while (node)
+    {
+        MessageAwaiter* waiter = static_cast<MessageAwaiter*>(node);
+        //The waiter lives in the coroutine frame, which resuming may free
+        node = node->next;
+        if (waiter->messageFilter.matches(msg))
+        {
+            waiter->received = msg;
+            waiter->handle.resume();
+        }
+        else 
+        {
+            if (keptLast) keptLast->next = waiter;
+            else keptFirst = waiter;
+            keptLast = waiter;
+        }
+    }
+    //Waits that did not match go back in one lock
+    if (keptFirst) messageWaits.pushList(keptFirst, keptLast);
+}
+
+void MessageAwaitables::deliverSysExStart()
+{
+    //An unterminated message is finished by the next one starting
+    if (collecting) deliverSysExEnd(false);
+
+    collecting = static_cast<SysExAwaiter*>(sysExWaits.takeAll());
+    for (AwaitNode* node = collecting; node; node = node->next)
+    {
+        SysExAwaiter* waiter = static_cast<SysExAwaiter*>(node);
+        SysExArena& arena = waiter->arena;
+        waiter->received.data = arena.data + arena.used;
+        waiter->received.length = 0;
+        waiter->received.complete = true;
+    }
+}
+
+void MessageAwaitables::deliverSysExByte(Byte byte)
+{
+    for (AwaitNode* node = collecting; node; node = node->next)
+    {
+        SysExAwaiter* waiter = static_cast<SysExAwaiter*>(node);
+        SysExArena& arena = waiter->arena;
+        if (arena.used < arena.capacity)
+        {
+            arena.data[arena.used++] = byte;
+            waiter->received.length++;
+        }
+        else waiter->received.complete = false;
+    }
+}
+
+void MessageAwaitables::deliverSysExEnd(bool valid)
+{
+    AwaitNode* node = collecting;
+    collecting = nullptr;
+    while (node)
+    {
+        SysExAwaiter* waiter = static_cast<SysExAwaiter*>(node);
+        node = node->next;
+        if (!valid) waiter->received.complete = false;
+        waiter->handle.resume();
+    }
+}
+
+void MessageAwaitables::cancelWaits()
+{
+    AwaitNode* node = messageWaits.takeAll();
+    while (node)
+    {
+        MessageAwaiter* waiter = static_cast<MessageAwaiter*>(node);
+        node = node->next;
+        waiter->received = Message::invalid();
+        waiter->handle.resume();
+    }
+
+    deliverSysExEnd(false);
+    node = sysExWaits.takeAll();
+    while (node)
+    {
+        SysExAwaiter* waiter = static_cast<SysExAwaiter*>(node);
+        node = node->next;
+        waiter->received.data = waiter->arena.data + waiter->arena.used;
+        waiter->received.length = 0;
+        waiter->received.complete = false;
+        waiter->handle.resume();
+    }
+}
+
+void AwaitableClock::start()
+{
+    pulseCount = 0;
+    playing = true;
+}
+
+void AwaitableClock::stop()
+{
+    playing = false;
+}
+
+void AwaitableClock::resume()
+{
+    playing = true;
+}
+
+void AwaitableClock::registerClockPulse(Word timestamp)
+{
+    //Clock keeps running while stopped, but only counts while playing
+    if (!playing) return;
+    unsigned long pulse = pulseCount++;
+    if ((pulse % pulsesPerBeat) != 0) return;
+
+    ClockBeat beat;
+    beat.beat = pulse / pulsesPerBeat;
+    beat.timestamp = timestamp;
+    beat.valid = true;
+    resumeWaits(beat);
+}
+
+void AwaitableClock::cancelWaits()
+{
+    ClockBeat beat;
+    beat.beat = pulseCount / pulsesPerBeat;
+    beat.timestamp = 0;
+    beat.valid = false;
+    resumeWaits(beat);
+}
+
+void AwaitableClock::resumeWaits(ClockBeat beat)
+{
+    AwaitNode* node = beatWaits.takeAll();
+    while (node)
+    {
+        BeatAwaiter* waiter = static_cast<BeatAwaiter*>(node);
+        node = node->next;
+        waiter->received = beat;
+        waiter->handle.resume();
+    }
+}
+
+#endif
+#endif
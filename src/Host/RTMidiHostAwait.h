@@ -0,0 +1,541 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostAwait.h 
+//!  @brief C++20 coroutine awaitables for messages, SysEx and clock beats
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_HOST_AWAIT_H_
+#define _RT_MIDI_HOST_AWAIT_H_
+
+#include "../Core/RTMidiCore.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include "../Input/RTMidiRXHandler.h"
+#include "../Input/RTMidiRealtimeControllers.h"
+#include "./RTMidiHostPipeline.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Fixed size block pool for coroutine frames, so that starting 
+     *        a coroutine does not touch the heap.  Thread safe: frames are 
+     *        usually allocated on one thread and freed on the thread that 
+     *        resumed the coroutine last.
+     */
+    class FrameAllocator 
+    {
+        public:
+            /**
+             * @param blockSize The largest frame, in bytes
+             * @param blockCount The most frames allocated at once
+             */
+            FrameAllocator(unsigned int blockSize, unsigned int blockCount);
+
+            /**
+             * @brief Allocate a block.
+             * 
+             * @return The block, or nullptr if size is larger than the block 
+             *         size or the pool is exhausted
+             */
+            void* allocate(std::size_t size);
+
+            void deallocate(void* block);
+
+            unsigned int getBlockSize() const { return blockSize; };
+
+            unsigned int getAvailable() const { return available.load(); };
+        protected:
+            struct FreeBlock 
+            {
+                FreeBlock* next;
+            };
+
+            unsigned int blockSize;
+            std::unique_ptr<std::max_align_t[]> storage;
+            FreeBlock* freeList;
+            std::atomic<unsigned int> available;
+            std::atomic_flag lock;
+
+            void acquire();
+            void release();
+    };
+}
+
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <new>
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Return type for a detached coroutine.  The coroutine starts 
+     *        when it is called and its frame is freed when it finishes.
+     * 
+     *        If the coroutine's first parameter (or the first after the 
+     *        object, for a member function) is a FrameAllocator, the frame 
+     *        is taken from that pool.  Otherwise it is allocated with 
+     *        operator new.  Either way it is one allocation per coroutine, 
+     *        not per co_await.
+     * 
+     *        @code
+     *        Task watchPedal(FrameAllocator&, AwaitableRxHandler& input)
+     *        {
+     *            while (true)
+     *            {
+     *                Message msg = co_await input.nextMessage(pedalFilter);
+     *                if (!msg.isValid()) co_return;
+     *                ...
+     *            }
+     *        }
+     *        @endcode
+     */
+    class Task 
+    {
+        public:
+            struct promise_type 
+            {
+                Task get_return_object() noexcept { return Task(true); };
+
+                static Task get_return_object_on_allocation_failure() noexcept
+                { 
+                    return Task(false); 
+                };
+
+                std::suspend_never initial_suspend() noexcept { return {}; };
+                std::suspend_never final_suspend() noexcept { return {}; };
+                void return_void() noexcept {};
+                void unhandled_exception() noexcept { std::terminate(); };
+
+                template<typename... ARGS>
+                static void* operator new(std::size_t size, 
+                                          FrameAllocator& allocator, 
+                                          ARGS&&...) noexcept 
+                {
+                    return allocateFrame(size, &allocator);
+                }
+
+                template<class OBJECT, typename... ARGS>
+                static void* operator new(std::size_t size, OBJECT&&, 
+                                          FrameAllocator& allocator, 
+                                          ARGS&&...) noexcept 
+                {
+                    return allocateFrame(size, &allocator);
+                }
+
+                static void* operator new(std::size_t size) noexcept 
+                {
+                    return allocateFrame(size, nullptr);
+                }
+
+                static void operator delete(void* frame) noexcept 
+                {
+                    freeFrame(frame);
+                }
+            };
+
+            /**
+             * @brief Check the coroutine was started.  False if its frame 
+             *        could not be allocated.
+             */
+            bool isValid() const { return started; };
+        protected:
+            bool started;
+
+            Task(bool wasStarted): started(wasStarted){};
+
+            //The allocator is kept in front of the frame, padded to keep 
+            //the frame aligned
+            static constexpr std::size_t FrameHeader = alignof(std::max_align_t);
+
+            static void* allocateFrame(std::size_t size, FrameAllocator* allocator);
+            static void freeFrame(void* frame);
+    };
+
+    /**
+     * @brief A suspended coroutine in an AwaitList.
+     */
+    struct AwaitNode 
+    {
+        AwaitNode* next;
+        std::coroutine_handle<> handle;
+    };
+
+    /**
+     * @brief FIFO list of suspended coroutines.  Nodes live in the 
+     *        coroutine frames, so waiting allocates nothing.  Pushing is 
+     *        thread safe, so coroutines can start waiting on any thread.
+     */
+    class AwaitList 
+    {
+        public:
+            AwaitList(): head(nullptr), tail(nullptr){ lock.clear(); };
+
+            void push(AwaitNode* node){ pushList(node, node); };
+
+            /**
+             * @brief Append a chain of nodes linked through next.
+             */
+            void pushList(AwaitNode* first, AwaitNode* last);
+
+            /**
+             * @brief Remove and return every node, as a chain linked 
+             *        through next.
+             */
+            AwaitNode* takeAll();
+        protected:
+            AwaitNode* head;
+            AwaitNode* tail;
+            std::atomic_flag lock;
+    };
+
+    /**
+     * @brief Bump allocated storage for received SysEx messages.  Each 
+     *        message awaited with the arena is appended after the previous 
+     *        one until reset() is called.  An arena must only be used by 
+     *        one wait at a time.
+     */
+    class SysExArena 
+    {
+        public:
+            SysExArena(Byte* buffer, unsigned int bufferLength):
+                data(buffer), capacity(bufferLength), used(0){};
+
+            void reset(){ used = 0; };
+
+            unsigned int getUsed() const { return used; };
+
+            unsigned int getCapacity() const { return capacity; };
+        protected:
+            friend class MessageAwaitables;
+            Byte* data;
+            unsigned int capacity;
+            unsigned int used;
+    };
+
+    /**
+     * @brief SysExArena with its own storage.
+     */
+    template<unsigned int LENGTH>
+    class StaticSysExArena: public SysExArena 
+    {
+        public:
+            StaticSysExArena(): SysExArena(storage, LENGTH){};
+        protected:
+            Byte storage[LENGTH];
+    };
+
+    /**
+     * @brief A received SysEx message.  data holds the bytes between the 
+     *        start and end status bytes.
+     */
+    struct SysExMessage 
+    {
+        const Byte* data;
+        unsigned int length;
+        //False if the message was aborted, cut short because the arena 
+        //filled, or the wait was cancelled
+        bool complete;
+    };
+
+    /**
+     * @brief A beat from an AwaitableClock.
+     */
+    struct ClockBeat 
+    {
+        //Beats since the last Start message
+        unsigned long beat;
+        //The timestamp of the clock pulse that started the beat
+        Word timestamp;
+        //False if the wait was cancelled
+        bool valid;
+    };
+
+    /**
+     * @brief Message and SysEx waits shared by the awaitable receivers.
+     * 
+     *        Waiting coroutines are resumed directly from the thread that 
+     *        delivers the message, so they run inline with the parser or 
+     *        dispatcher and must not block.  A resumed coroutine that waits 
+     *        again waits for the next message, not the current one.
+     * 
+     *        Delivery, and cancelWaits(), must all happen on one thread.
+     */
+    class MessageAwaitables 
+    {
+        public:
+            class MessageAwaiter: public AwaitNode 
+            {
+                public:
+                    MessageAwaiter(MessageAwaitables& source, MessageFilter filter):
+                        owner(source), messageFilter(filter){};
+
+                    bool await_ready() const noexcept { return false; };
+
+                    void await_suspend(std::coroutine_handle<> waiting) noexcept 
+                    {
+                        handle = waiting;
+                        //May resume on another thread before this returns, 
+                        //so nothing may be touched after the push
+                        owner.messageWaits.push(this);
+                    }
+
+                    Message await_resume() const noexcept { return received; };
+                protected:
+                    friend class MessageAwaitables;
+                    MessageAwaitables& owner;
+                    MessageFilter messageFilter;
+                    Message received;
+            };
+
+            class SysExAwaiter: public AwaitNode 
+            {
+                public:
+                    SysExAwaiter(MessageAwaitables& source, SysExArena& sysExArena):
+                        owner(source), arena(sysExArena){};
+
+                    bool await_ready() const noexcept { return false; };
+
+                    void await_suspend(std::coroutine_handle<> waiting) noexcept 
+                    {
+                        handle = waiting;
+                        owner.sysExWaits.push(this);
+                    }
+
+                    SysExMessage await_resume() const noexcept { return received; };
+                protected:
+                    friend class MessageAwaitables;
+                    MessageAwaitables& owner;
+                    SysExArena& arena;
+                    SysExMessage received;
+            };
+
+            MessageAwaitables(): collecting(nullptr){};
+
+            /**
+             * @brief Wait for the next message that passes a filter.  
+             *        Resumes with Message::invalid() if cancelled.
+             */
+            MessageAwaiter nextMessage(MessageFilter filter = MessageFilter())
+            {
+                return MessageAwaiter(*this, filter);
+            }
+
+            /**
+             * @brief Wait for the next SysEx message to start and end, 
+             *        storing it in an arena.
+             */
+            SysExAwaiter nextSysEx(SysExArena& arena)
+            {
+                return SysExAwaiter(*this, arena);
+            }
+
+            /**
+             * @brief Resume every waiting coroutine with an invalid message, 
+             *        so that they can finish.
+             */
+            void cancelWaits();
+        protected:
+            AwaitList messageWaits;
+            AwaitList sysExWaits;
+            //SysEx waits collecting the current message, only touched by 
+            //the delivering thread
+            SysExAwaiter* collecting;
+
+            void deliverMessage(Message msg);
+            void deliverSysExStart();
+            void deliverSysExByte(Byte byte);
+            void deliverSysExEnd(bool valid);
+    };
+
+    /**
+     * @brief Parser whose messages can be awaited.  Coroutines resume on 
+     *        the thread calling receiveByte() or receiveBytes(), for 
+     *        example the EpollTransport thread.
+     */
+    class AwaitableRxHandler: public RxHandler, public MessageAwaitables 
+    {
+        public:
+            /**
+             * @param realtimeController (optional) Controller for realtime 
+             *        messages, such as an AwaitableClock
+             */
+            AwaitableRxHandler(RealtimeController* realtimeController = nullptr):
+                realtimeCtrl(realtimeController){};
+        protected:
+            RealtimeController* realtimeCtrl;
+
+            void standardMessageReceived(Message msg) override 
+            {
+                deliverMessage(msg);
+            }
+
+            void realtimeMessageReceived(Message msg, Word timestamp) override 
+            {
+                dispatchRealtimeMessage(realtimeCtrl, msg, timestamp);
+                deliverMessage(msg);
+            }
+
+            void sysExStatusChanged(bool terminated, bool startedOrValid) override 
+            {
+                if (terminated) deliverSysExEnd(startedOrValid);
+                else if (startedOrValid) deliverSysExStart();
+            }
+
+            void sysExByteReceived(Byte byte) override 
+            {
+                deliverSysExByte(byte);
+            }
+    };
+
+    /**
+     * @brief PipelineTarget whose messages can be awaited.  Coroutines 
+     *        resume on the Pipeline's dispatch thread, so a slow coroutine 
+     *        never delays parsing.
+     */
+    class AwaitablePipelineTarget: public PipelineTarget, public MessageAwaitables 
+    {
+        public:
+            AwaitablePipelineTarget(RealtimeController* realtimeController = nullptr):
+                realtimeCtrl(realtimeController){};
+
+            void messageReceived(Message msg, Word timestamp) override 
+            {
+                if (msg.getStatus() >= StatusByte::SystemRealtimeMin)
+                {
+                    dispatchRealtimeMessage(realtimeCtrl, msg, timestamp);
+                }
+                deliverMessage(msg);
+            }
+
+            void sysExStarted() override { deliverSysExStart(); };
+            void sysExByteReceived(Byte byte) override { deliverSysExByte(byte); };
+            void sysExEnded(bool valid) override { deliverSysExEnd(valid); };
+        protected:
+            RealtimeController* realtimeCtrl;
+    };
+
+    /**
+     * @brief MIDI clock follower whose beats can be awaited.  Beat 0 is 
+     *        the first clock pulse after a Start message.
+     */
+    class AwaitableClock: public RealtimeController 
+    {
+        public:
+            class BeatAwaiter: public AwaitNode 
+            {
+                public:
+                    BeatAwaiter(AwaitableClock& source): owner(source){};
+
+                    bool await_ready() const noexcept { return false; };
+
+                    void await_suspend(std::coroutine_handle<> waiting) noexcept 
+                    {
+                        handle = waiting;
+                        owner.beatWaits.push(this);
+                    }
+
+                    ClockBeat await_resume() const noexcept { return received; };
+                protected:
+                    friend class AwaitableClock;
+                    AwaitableClock& owner;
+                    ClockBeat received;
+            };
+
+            /**
+             * @param pulses The clock pulses per beat.  MIDI clock runs at 
+             *        24 pulses per quarter note.
+             */
+            AwaitableClock(unsigned int pulses = 24): 
+                pulsesPerBeat(pulses ? pulses : 1), 
+                pulseCount(0), 
+                playing(false){};
+
+            /**
+             * @brief Wait for the start of the next beat.
+             */
+            BeatAwaiter nextBeat(){ return BeatAwaiter(*this); };
+
+            bool isPlaying() const { return playing; };
+
+            /**
+             * @brief Resume every waiting coroutine with an invalid beat.  
+             *        Must be called on the thread that delivers clock pulses.
+             */
+            void cancelWaits();
+
+            void start() override;
+            void stop() override;
+            void resume() override;
+            void registerClockPulse(Word timestamp) override;
+        protected:
+            unsigned int pulsesPerBeat;
+            unsigned long pulseCount;
+            bool playing;
+            AwaitList beatWaits;
+
+            void resumeWaits(ClockBeat beat);
+    };
+}
+
+#endif
+#endif
+#endif
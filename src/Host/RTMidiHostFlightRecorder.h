@@ -0,0 +1,114 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostFlightRecorder.h 
+//!  @brief Writing flight recorder dumps to files on a Linux host
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_HOST_FLIGHT_RECORDER_H_
+#define _RT_MIDI_HOST_FLIGHT_RECORDER_H_
+
+#include "../Core/RTMidiCore.h"
+
+#if RTMIDI_HOST_LINUX
+
+namespace RTMIDI 
+{
+    /**
+     * @brief FlightDumpWriter for a file descriptor.  It only uses write(), 
+     *        so it may be used from a signal handler.
+     */
+    class FileDumpWriter: public FlightDumpWriter 
+    {
+        public:
+            FileDumpWriter(int fileDescriptor): fd(fileDescriptor){};
+
+            bool write(const Byte* data, unsigned int length) override;
+        protected:
+            int fd;
+    };
+
+    /**
+     * @brief Freeze a recorder and dump it to a file, replacing the file 
+     *        if it exists.
+     * 
+     * @param recorder The recorder
+     * @param path The file to write
+     * @param ticksPerSecond The rate of the recorder's clock, 1000000 for 
+     *                       hostMicros()
+     * @return False if the file could not be written
+     */
+    bool dumpFlightRecorder(FlightRecorder& recorder, const char* path, 
+                            uint32_t ticksPerSecond = 1000000);
+
+    /**
+     * @brief Dump a recorder to a file when the process crashes or aborts 
+     *        (SIGSEGV, SIGBUS, SIGILL, SIGFPE or SIGABRT).  The signal is 
+     *        raised again after the dump, so the process still terminates 
+     *        as it would have done.
+     * 
+     *        Only one recorder can be installed; installing another 
+     *        replaces it.  The recorder and path must remain valid.
+     * 
+     * @return False if the signal handlers could not be installed
+     */
+    bool installFlightRecorderFaultHandler(FlightRecorder& recorder, 
+                                           const char* path, 
+                                           uint32_t ticksPerSecond = 1000000);
+}
+
+#endif
+#endif
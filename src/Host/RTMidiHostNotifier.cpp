@@ -0,0 +1,151 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostNotifier.cpp 
+//!  @brief eventfd and futex buffer notifiers for Linux hosts
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiHostNotifier.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace RTMIDI;
+
+EventFdNotifier::EventFdNotifier()
+{
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+EventFdNotifier::~EventFdNotifier()
+{
+    if (fd >= 0) close(fd);
+}
+
+void EventFdNotifier::clear()
+{
+    uint64_t value;
+    ssize_t result = read(fd, &value, sizeof(value));
+    (void)result;
+}
+
+void EventFdNotifier::notify()
+{
+    uint64_t one = 1;
+    ssize_t result = write(fd, &one, sizeof(one));
+    (void)result;
+}
+
+bool EventFdNotifier::wait(int timeoutMillis)
+{
+    struct pollfd descriptor;
+    descriptor.fd = fd;
+    descriptor.events = POLLIN;
+    int result;
+    do 
+    {
+        result = ::poll(&descriptor, 1, timeoutMillis);
+    } while ((result < 0) && (errno == EINTR));
+    if (result <= 0) return false;
+    clear();
+    return true;
+}
+
+void FutexNotifier::notify()
+{
+    if (signalled.exchange(1) != 0) return;
+    if (sleepers.load() == 0) return;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signalled), 
+            FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+bool FutexNotifier::wait(int timeoutMillis)
+{
+    if (signalled.exchange(0) != 0) return true;
+
+    struct timespec timeout;
+    struct timespec* timeoutPointer = nullptr;
+    if (timeoutMillis >= 0)
+    {
+        timeout.tv_sec = timeoutMillis / 1000;
+        timeout.tv_nsec = (timeoutMillis % 1000) * 1000000L;
+        timeoutPointer = &timeout;
+    }
+
+    //Registering as a sleeper before checking the flag means a notify() 
+    //after the check always sees the sleeper and wakes it
+    sleepers.fetch_add(1);
+    bool timedOut = false;
+    while (!signalled.load() && !timedOut)
+    {
+        long result = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signalled), 
+                              FUTEX_WAIT_PRIVATE, 0, timeoutPointer, nullptr, 0);
+        timedOut = (result < 0) && (errno == ETIMEDOUT);
+    }
+    sleepers.fetch_sub(1);
+    return signalled.exchange(0) != 0;
+}
+
+#endif
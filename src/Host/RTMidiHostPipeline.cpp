@@ -0,0 +1,258 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostPipeline.cpp 
+//!  @brief Runs parsing, dispatch and transmission on separate threads
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiHostPipeline.h"
+
+#if RTMIDI_HOST_LINUX
+
+using namespace RTMIDI;
+
+constexpr unsigned int Pipeline::QueueLength;
+constexpr unsigned int Pipeline::BlockSize;
+constexpr unsigned int Pipeline::DefaultBatchLength;
+
+Pipeline::Pipeline(ByteSource* input, PipelineTarget* pipelineTarget,
+                   TxHandler* output, ByteSink* outputSink):
+    source(input),
+    target(pipelineTarget),
+    txHandler(output),
+    sink(outputSink),
+    waitPolicy(WaitPolicy::Block),
+    batchLength(DefaultBatchLength),
+    cpus{-1, -1, -1},
+    parser(*this),
+    transmitWakeNanos(0),
+    running(false)
+{
+}
+
+Pipeline::~Pipeline()
+{
+    stop();
+}
+
+void Pipeline::setCpu(PipelineStage stage, int cpu)
+{
+    cpus[static_cast<Byte>(stage)] = cpu;
+}
+
+bool Pipeline::start()
+{
+    if (running.exchange(true)) return false;
+    bool pinned = true;
+    if (source) 
+    {
+        threads[0] = std::thread(&Pipeline::parseLoop, this);
+        pinned &= pinThread(threads[0], cpus[0]);
+    }
+    if (target) 
+    {
+        threads[1] = std::thread(&Pipeline::dispatchLoop, this);
+        pinned &= pinThread(threads[1], cpus[1]);
+    }
+    if (txHandler && sink) 
+    {
+        threads[2] = std::thread(&Pipeline::transmitLoop, this);
+        pinned &= pinThread(threads[2], cpus[2]);
+    }
+    return pinned;
+}
+
+void Pipeline::stop()
+{
+    if (!running.exchange(false)) return;
+    dispatchSignal.notify();
+    transmitSignal.notify();
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        if (threads[i].joinable()) threads[i].join();
+    }
+}
+
+void Pipeline::wakeTransmitter()
+{
+    uint64_t expected = 0;
+    transmitWakeNanos.compare_exchange_strong(expected, hostNanos());
+    transmitSignal.notify();
+}
+
+StageStatistics Pipeline::getStatistics(PipelineStage stage) const
+{
+    return counters[static_cast<Byte>(stage)].snapshot();
+}
+
+bool Pipeline::queueEntry(EntryKind kind, Message msg, Word timestamp)
+{
+    if (queue.isFull())
+    {
+        counters[0].recordDrop();
+        return false;
+    }
+    Entry entry;
+    entry.msg = msg;
+    entry.timestamp = timestamp;
+    entry.queuedNanos = hostNanos();
+    entry.kind = kind;
+    queue.push(entry);
+    return true;
+}
+
+void Pipeline::parseLoop()
+{
+    Byte buffer[BlockSize];
+    //Only block in the source when the policy allows sleeping
+    int timeout = (waitPolicy == WaitPolicy::Block) ? 10 : 0;
+    while (running.load(std::memory_order_relaxed))
+    {
+        int length = source->readBytes(buffer, BlockSize, timeout);
+        if (length < 0) break;
+        if (length == 0)
+        {
+            if (parser.queuePendingEnd()) dispatchSignal.notify();
+            pollPause(waitPolicy);
+            continue;
+        }
+        uint64_t start = hostNanos();
+        Word timestamp = static_cast<Word>(start / 1000);
+        parser.setTimestamp(timestamp);
+        for (int i = 0; i < length; i++)
+        {
+            parser.receiveByte(buffer[i], timestamp);
+        }
+        dispatchSignal.notify();
+        uint64_t busy = hostNanos() - start;
+        counters[0].recordBatch(length, busy);
+        counters[0].recordLatency(busy);
+    }
+}
+
+void Pipeline::dispatchEntry(const Entry& entry)
+{
+    switch (entry.kind)
+    {
+        case EntryKind::Message:
+            target->messageReceived(entry.msg, entry.timestamp);
+            break;
+        case EntryKind::SysExStart:
+            target->sysExStarted();
+            break;
+        case EntryKind::SysExByte:
+            target->sysExByteReceived(entry.msg.getStatus());
+            break;
+        case EntryKind::SysExEnd:
+            target->sysExEnded(true);
+            break;
+        case EntryKind::SysExAbort:
+            target->sysExEnded(false);
+            break;
+    }
+}
+
+void Pipeline::dispatchLoop()
+{
+    StageCounters& stats = counters[1];
+    while (running.load(std::memory_order_relaxed))
+    {
+        if (!queue.available())
+        {
+            dispatchSignal.wait(waitPolicy);
+            continue;
+        }
+        uint64_t start = hostNanos();
+        uint64_t count = 0;
+        while ((count < batchLength) && queue.available())
+        {
+            Entry entry = queue.pop();
+            stats.recordLatency(hostNanos() - entry.queuedNanos);
+            dispatchEntry(entry);
+            count++;
+        }
+        target->batchComplete();
+        stats.recordBatch(count, hostNanos() - start);
+    }
+}
+
+void Pipeline::transmitLoop()
+{
+    StageCounters& stats = counters[2];
+    Byte buffer[BlockSize];
+    while (running.load(std::memory_order_relaxed))
+    {
+        unsigned int length = 0;
+        int nextByte;
+        while ((length < BlockSize) && ((nextByte = txHandler->getNextByte()) >= 0))
+        {
+            buffer[length++] = nextByte;
+        }
+        if (length == 0)
+        {
+            transmitSignal.wait(waitPolicy);
+            continue;
+        }
+        uint64_t start = hostNanos();
+        if (sink->writeBytes(buffer, length) < 0) break;
+        uint64_t end = hostNanos();
+        uint64_t woken = transmitWakeNanos.exchange(0);
+        if (woken) stats.recordLatency(end - woken);
+        stats.recordBatch(length, end - start);
+    }
+}
+
+#endif
@@ -0,0 +1,415 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostPipeline.h 
+//!  @brief Runs parsing, dispatch and transmission on separate threads
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_HOST_PIPELINE_H_
+#define _RT_MIDI_HOST_PIPELINE_H_
+
+#include "../Core/RTMidiCore.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include "../Input/RTMidiStaticRxHandler.h"
+#include "../Output/RTMidiTxHandler.h"
+#include "./RTMidiHostStage.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Interface class for a source of received MIDI bytes.
+     */
+    class ByteSource 
+    {
+        public:
+            virtual ~ByteSource(){};
+
+            /**
+             * @brief Read the bytes available, waiting up to timeoutMillis 
+             *        for the first one.
+             * 
+             * @return The number of bytes read, 0 if none arrived in time, 
+             *         or -1 if the source is closed.
+             */
+            virtual int readBytes(Byte* buffer, unsigned int length, 
+                                  int timeoutMillis) = 0;
+    };
+
+    /**
+     * @brief Interface class for a destination of transmitted MIDI bytes.
+     */
+    class ByteSink 
+    {
+        public:
+            virtual ~ByteSink(){};
+
+            /**
+             * @brief Write bytes, waiting until all of them are written.
+             * 
+             * @return The number of bytes written, or -1 on error.
+             */
+            virtual int writeBytes(const Byte* data, unsigned int length) = 0;
+    };
+
+    /**
+     * @brief Interface class for the receiver at the end of a Pipeline's 
+     *        dispatch stage.  All functions are called from the dispatch 
+     *        thread.
+     */
+    class PipelineTarget 
+    {
+        public:
+            virtual ~PipelineTarget(){};
+            virtual void messageReceived(Message msg, Word timestamp) = 0;
+            virtual void sysExStarted(){};
+            virtual void sysExByteReceived(Byte byte){};
+
+            /**
+             * @brief Called when a SysEx ends.
+             * 
+             * @param valid True if it was ended by F7 and none of its bytes 
+             *              were dropped.  False if it was aborted by another
+             *              status byte or is incomplete.
+             */
+            virtual void sysExEnded(bool valid){};
+
+            /**
+             * @brief Called after each batch of messages taken from the queue.
+             */
+            virtual void batchComplete(){};
+    };
+
+    /**
+     * @brief PipelineTarget that delivers to an input device, such as an 
+     *        InputDevice or StaticInputDevice.  Parsed messages are passed 
+     *        with receiveMessage(), SysEx is passed as bytes through the 
+     *        device's own parser, and processMessages() is called after 
+     *        each batch, so all listeners run on the dispatch thread.
+     * 
+     * @tparam DEVICE The input device class
+     */
+    template<class DEVICE>
+    class DevicePipelineTarget: public PipelineTarget 
+    {
+        public:
+            DevicePipelineTarget(DEVICE& inputDevice): device(inputDevice){};
+
+            void messageReceived(Message msg, Word timestamp) override 
+            {
+                device.receiveMessage(msg, timestamp);
+            }
+
+            void sysExStarted() override 
+            {
+                device.receiveByte(static_cast<Byte>(SystemCommonCode::SysExStart));
+            }
+
+            void sysExByteReceived(Byte byte) override 
+            {
+                device.receiveByte(byte);
+            }
+
+            void sysExEnded(bool valid) override 
+            {
+                if (valid) device.receiveByte(static_cast<Byte>(SystemCommonCode::SysExEnd));
+                else device.abortSysEx();
+            }
+
+            void batchComplete() override 
+            {
+                device.processMessages();
+            }
+        protected:
+            DEVICE& device;
+    };
+
+    /**
+     * @brief The stages of a Pipeline.
+     */
+    enum class PipelineStage: Byte 
+    {
+        Parse = 0,
+        Dispatch = 1,
+        Transmit = 2
+    };
+
+    /**
+     * @brief Host runtime that runs parsing, dispatch and transmission as 
+     *        pipeline stages on their own threads.
+     * 
+     *        - Parse reads bytes from the ByteSource, parses them and 
+     *          queues the results.  It never waits for the other stages: 
+     *          if the queue is full, messages are dropped and counted.  
+     *          A SysEx that loses any of its bytes is ended as invalid.
+     *        - Dispatch takes messages from the queue and delivers them to
+     *          the PipelineTarget, where listeners run.
+     *        - Transmit pumps bytes from the TxHandler to the ByteSink 
+     *          whenever wakeTransmitter() is called (normally from the 
+     *          TxHandler's restartTransmission()).
+     * 
+     *        The stages are connected by single producer, single consumer 
+     *        RingBuffers, so no locks are taken on the data path.  A slow 
+     *        listener therefore only delays dispatch, never ingestion.
+     * 
+     *        Each stage can be pinned to a CPU, and the wait policy sets 
+     *        how idle stages wait.  Per stage counters record items, busy 
+     *        time and latency: for Parse the time to parse each read, for 
+     *        Dispatch the time each message spent queued, and for Transmit 
+     *        the time from wakeTransmitter() to the bytes being written.
+     */
+    class Pipeline 
+    {
+        public:
+            static constexpr unsigned int QueueLength = 1024;
+            static constexpr unsigned int BlockSize = 256;
+            static constexpr unsigned int DefaultBatchLength = 16;
+
+            Pipeline(ByteSource* input = nullptr, 
+                     PipelineTarget* target = nullptr,
+                     TxHandler* output = nullptr, 
+                     ByteSink* outputSink = nullptr);
+
+            ~Pipeline();
+
+            /**
+             * @brief Set how idle stages wait.  Takes effect on start().
+             */
+            void setWaitPolicy(WaitPolicy policy){ waitPolicy = policy; };
+
+            /**
+             * @brief Set the most messages dispatched before the target's 
+             *        batchComplete() is called.  When the target is an 
+             *        input device this must be less than the device's 
+             *        message buffer length.
+             */
+            void setDispatchBatchLength(unsigned int length)
+            { 
+                batchLength = length ? length : 1; 
+            };
+
+            /**
+             * @brief Pin a stage's thread to a CPU.  Takes effect on start().
+             * 
+             * @param stage The stage
+             * @param cpu The CPU number, or -1 for no pinning
+             */
+            void setCpu(PipelineStage stage, int cpu);
+
+            /**
+             * @brief Start the stage threads.
+             * 
+             * @return False if the pipeline was already running or a stage 
+             *         could not be pinned.  Stages that could not be pinned 
+             *         still run.
+             */
+            bool start();
+
+            /**
+             * @brief Stop and join the stage threads.
+             */
+            void stop();
+
+            bool isRunning() const { return running.load(); };
+
+            /**
+             * @brief Tell the transmit stage that the TxHandler has new data.
+             *        Safe to call from any thread.
+             */
+            void wakeTransmitter();
+
+            StageStatistics getStatistics(PipelineStage stage) const;
+
+        protected:
+            enum class EntryKind: Byte 
+            {
+                Message,
+                SysExStart,
+                SysExByte,
+                SysExEnd,
+                SysExAbort
+            };
+
+            struct Entry 
+            {
+                RTMIDI::Message msg;
+                Word timestamp;
+                uint64_t queuedNanos;
+                EntryKind kind;
+            };
+
+            /**
+             * @brief The parse stage's parser, queueing everything it parses.
+             */
+            class Parser: public StaticRxHandler<Parser>
+            {
+                public:
+                    Parser(Pipeline& owner): pipeline(owner), 
+                                             timestamp(0), 
+                                             inSysEx(false),
+                                             sysExDropped(false),
+                                             endPending(false),
+                                             endKind(EntryKind::SysExEnd){};
+
+                    void setTimestamp(Word time){ timestamp = time; };
+
+                    void standardMessageReceived(Message msg)
+                    {
+                        queue(EntryKind::Message, msg, timestamp);
+                    }
+
+                    void realtimeMessageReceived(Message msg, Word time)
+                    {
+                        queue(EntryKind::Message, msg, time);
+                    }
+
+                    void sysExStatusChanged(bool terminated, bool startedOrValid)
+                    {
+                        if (terminated)
+                        {
+                            if (!inSysEx) return;
+                            inSysEx = false;
+                            endPending = true;
+                            endKind = (startedOrValid && !sysExDropped) ? 
+                                      EntryKind::SysExEnd : EntryKind::SysExAbort;
+                            queuePendingEnd();
+                        }
+                        else if (startedOrValid)
+                        {
+                            //A SysEx whose start was dropped is skipped
+                            sysExDropped = false;
+                            inSysEx = queue(EntryKind::SysExStart, 
+                                            Message(), timestamp);
+                        }
+                    }
+
+                    void sysExByteReceived(Byte byte)
+                    {
+                        if (!inSysEx) return;
+                        if (!queue(EntryKind::SysExByte, Message(byte, 0), 
+                                   timestamp))
+                        {
+                            sysExDropped = true;
+                        }
+                    }
+
+                    /**
+                     * @brief Queue the end of a SysEx that did not fit in 
+                     *        the queue when it was parsed.
+                     * 
+                     * @return True if an end was queued by this call
+                     */
+                    bool queuePendingEnd()
+                    {
+                        //Waiting for room is not a drop, so is not counted
+                        if (!endPending || pipeline.queue.isFull()) return false;
+                        endPending = !pipeline.queueEntry(endKind, Message(), 
+                                                          timestamp);
+                        return !endPending;
+                    }
+                protected:
+                    Pipeline& pipeline;
+                    Word timestamp;
+                    bool inSysEx;
+                    //A byte of the current SysEx did not fit in the queue
+                    bool sysExDropped;
+                    //The end of the last SysEx still has to be queued
+                    bool endPending;
+                    EntryKind endKind;
+
+                    bool queue(EntryKind kind, Message msg, Word time)
+                    {
+                        //Nothing may overtake the end of a SysEx, or the 
+                        //target would never see it end
+                        queuePendingEnd();
+                        if (endPending)
+                        {
+                            pipeline.counters[0].recordDrop();
+                            return false;
+                        }
+                        return pipeline.queueEntry(kind, msg, time);
+                    }
+            };
+
+            ByteSource* source;
+            PipelineTarget* target;
+            TxHandler* txHandler;
+            ByteSink* sink;
+            WaitPolicy waitPolicy;
+            unsigned int batchLength;
+            int cpus[3];
+
+            Parser parser;
+            RingBuffer<Entry, QueueLength, uint16_t> queue;
+            StageSignal dispatchSignal;
+            StageSignal transmitSignal;
+            std::atomic<uint64_t> transmitWakeNanos;
+            StageCounters counters[3];
+
+            std::atomic<bool> running;
+            std::thread threads[3];
+
+            bool queueEntry(EntryKind kind, Message msg, Word timestamp);
+            void parseLoop();
+            void dispatchLoop();
+            void transmitLoop();
+            void dispatchEntry(const Entry& entry);
+    };
+}
+
+#endif
+#endif
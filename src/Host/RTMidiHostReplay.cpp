@@ -0,0 +1,474 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostReplay.cpp 
+//!  @brief Replay of recorded byte traces and Standard MIDI Files at full speed or in real time
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiHostReplay.h"
+#include "../Input/RTMidiStaticRxHandler.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace RTMIDI;
+
+constexpr uint64_t RawReplaySource::MidiByteNanos;
+
+bool MappedFile::open(const char* path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+        madvise(mapping, info.st_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+        data = static_cast<const Byte*>(mapping);
+        size = info.st_size;
+    }
+    //The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data) munmap(const_cast<Byte*>(data), size);
+    data = nullptr;
+    size = 0;
+}
+
+bool RawReplaySource::next(ReplayChunk& chunk, uint64_t maxGapNanos)
+{
+    if (offset >= length) return false;
+    size_t chunkLength = length - offset;
+    if (chunkLength > blockSize) chunkLength = blockSize;
+    if (byteNanos && (maxGapNanos / byteNanos + 1 < chunkLength))
+    {
+        chunkLength = maxGapNanos / byteNanos + 1;
+    }
+    chunk.data = data + offset;
+    chunk.length = chunkLength;
+    chunk.timeNanos = offset * byteNanos;
+    offset += chunkLength;
+    return true;
+}
+
+static Word readWord(const Byte* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | 
+           (static_cast<Word>(data[3]) << 24);
+}
+
+FlightReplaySource::FlightReplaySource(const Byte* data, size_t length, 
+                                       bool transmitted): 
+    entries(nullptr), count(0), index(0), ticksPerSecond(1000000), 
+    ticks(0), valid(false)
+{
+    //Header, then a header and the entries for each track
+    if (length < 24 || memcmp(data, "RTFR", 4) != 0) return;
+    if (data[4] != FlightRecorder::DumpVersion) return;
+    if (readWord(data + 8)) ticksPerSecond = readWord(data + 8);
+    size_t offset = 12;
+    for (int track = 0; track <= (transmitted ? 1 : 0); track++)
+    {
+        if (length - offset < 12) return;
+        count = readWord(data + offset);
+        offset += 12;
+        if ((length - offset) / 4 < count) return;
+        entries = data + offset;
+        offset += count * 4;
+    }
+    valid = true;
+}
+
+void FlightReplaySource::rewind()
+{
+    index = 0;
+    ticks = 0;
+}
+
+bool FlightReplaySource::next(ReplayChunk& chunk, uint64_t maxGapNanos)
+{
+    if (!valid || index >= count) return false;
+    unsigned int length = 0;
+    uint64_t firstTicks = ticks;
+    //The first delta is to a byte that was not kept
+    if (index > 0) firstTicks += FlightTrack::entryDelta(readWord(entries + index * 4));
+    chunk.timeNanos = firstTicks * 1000000000 / ticksPerSecond;
+    while ((index < count) && (length < sizeof(block)))
+    {
+        Word entry = readWord(entries + index * 4);
+        uint64_t entryTicks = (index > 0) ? ticks + FlightTrack::entryDelta(entry) : 0;
+        uint64_t entryNanos = entryTicks * 1000000000 / ticksPerSecond;
+        if (entryNanos - chunk.timeNanos > maxGapNanos) break;
+        block[length++] = FlightTrack::entryByte(entry);
+        ticks = entryTicks;
+        index++;
+    }
+    chunk.data = block;
+    chunk.length = length;
+    return true;
+}
+
+static bool readVariableLength(const Byte*& position, const Byte* end, uint32_t& value)
+{
+    value = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        if (position >= end) return false;
+        Byte next = *position++;
+        value = (value << 7) | (next & 0x7F);
+        if (!(next & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint32_t readBigEndian(const Byte* data, int length)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < length; i++) value = (value << 8) | data[i];
+    return value;
+}
+
+SmfReplaySource::SmfReplaySource(const Byte* data, size_t length, 
+                                 unsigned int blockSize):
+    blockSize(blockSize), division(0), valid(false)
+{
+    if (length < 14 || memcmp(data, "MThd", 4) != 0) return;
+    uint32_t headerLength = readBigEndian(data + 4, 4);
+    if (headerLength < 6 || headerLength > length - 8) return;
+    unsigned int format = readBigEndian(data + 8, 2);
+    unsigned int trackCount = readBigEndian(data + 10, 2);
+    division = readBigEndian(data + 12, 2);
+    //Format 2 tracks are independent sequences, not one performance
+    if (format > 1 || division == 0) return;
+
+    size_t offset = 8 + headerLength;
+    while ((tracks.size() < trackCount) && (length - offset >= 8))
+    {
+        uint32_t chunkLength = readBigEndian(data + offset + 4, 4);
+        if (chunkLength > length - offset - 8) return;
+        if (memcmp(data + offset, "MTrk", 4) == 0)
+        {
+            Track track;
+            track.start = data + offset + 8;
+            track.end = track.start + chunkLength;
+            tracks.push_back(track);
+        }
+        //Unknown chunk types are skipped
+        offset += 8 + chunkLength;
+    }
+    block.reserve(blockSize);
+    valid = true;
+    rewind();
+}
+
+void SmfReplaySource::rewind()
+{
+    tempo = 500000;
+    tempoTick = 0;
+    tempoNanos = 0;
+    for (Track& track: tracks)
+    {
+        track.position = track.start;
+        track.tick = 0;
+        track.runningStatus = 0;
+        track.finished = false;
+        readDelta(track);
+    }
+}
+
+bool SmfReplaySource::readDelta(Track& track)
+{
+    uint32_t delta;
+    if (!readVariableLength(track.position, track.end, delta)) 
+    {
+        track.finished = true;
+        return false;
+    }
+    track.tick += delta;
+    return true;
+}
+
+SmfReplaySource::Track* SmfReplaySource::nextTrack()
+{
+    Track* earliest = nullptr;
+    for (Track& track: tracks)
+    {
+        if (track.finished) continue;
+        if (!earliest || track.tick < earliest->tick) earliest = &track;
+    }
+    return earliest;
+}
+
+uint64_t SmfReplaySource::tickNanos(uint64_t tick) const 
+{
+    if (division & 0x8000)
+    {
+        //SMPTE: frames per second (negative) and ticks per frame
+        int framesPerSecond = -static_cast<int8_t>(division >> 8);
+        uint64_t ticksPerSecond = framesPerSecond * (division & 0xFF);
+        if (framesPerSecond == 29) ticksPerSecond = ticksPerSecond * 2997 / 2900;
+        return ticksPerSecond ? tick * 1000000000 / ticksPerSecond : 0;
+    }
+    return tempoNanos + (tick - tempoTick) * tempo * 1000 / division;
+}
+
+bool SmfReplaySource::emitEvent(Track& track)
+{
+    const Byte*& position = track.position;
+    if (position >= track.end) return false;
+    Byte status = *position;
+    if (status & 0x80) position++;
+    else if (track.runningStatus) status = track.runningStatus;
+    else return false;
+
+    uint32_t length;
+    if (status == 0xFF)
+    {
+        if (position >= track.end) return false;
+        Byte type = *position++;
+        if (!readVariableLength(position, track.end, length)) return false;
+        if (length > static_cast<size_t>(track.end - position)) return false;
+        if (type == 0x2F) return false;
+        if ((type == 0x51) && (length == 3) && !(division & 0x8000))
+        {
+            tempoNanos = tickNanos(track.tick);
+            tempoTick = track.tick;
+            tempo = readBigEndian(position, 3);
+        }
+        position += length;
+        track.runningStatus = 0;
+        return true;
+    }
+    if ((status == 0xF0) || (status == 0xF7))
+    {
+        if (!readVariableLength(position, track.end, length)) return false;
+        if (length > static_cast<size_t>(track.end - position)) return false;
+        if (status == 0xF0) block.push_back(0xF0);
+        block.insert(block.end(), position, position + length);
+        position += length;
+        track.runningStatus = 0;
+        return true;
+    }
+    if (status > 0xF0) return false;
+
+    unsigned int dataLength = ((status & 0xE0) == 0xC0) ? 1 : 2;
+    if (static_cast<size_t>(track.end - position) < dataLength) return false;
+    block.push_back(status);
+    block.insert(block.end(), position, position + dataLength);
+    position += dataLength;
+    track.runningStatus = status;
+    return true;
+}
+
+bool SmfReplaySource::next(ReplayChunk& chunk, uint64_t maxGapNanos)
+{
+    block.clear();
+    Track* track = nextTrack();
+    if (!track) return false;
+    chunk.timeNanos = tickNanos(track->tick);
+    while (track && (block.size() < blockSize))
+    {
+        if (tickNanos(track->tick) - chunk.timeNanos > maxGapNanos) break;
+        if (emitEvent(*track)) readDelta(*track);
+        else track->finished = true;
+        track = nextTrack();
+    }
+    chunk.data = block.data();
+    chunk.length = block.size();
+    return true;
+}
+
+bool ChainedReplaySource::next(ReplayChunk& chunk, uint64_t maxGapNanos)
+{
+    while (current < sources.size())
+    {
+        if (sources[current]->next(chunk, maxGapNanos))
+        {
+            chunk.timeNanos += offsetNanos;
+            lastNanos = chunk.timeNanos;
+            return true;
+        }
+        offsetNanos = lastNanos;
+        current++;
+        if (current < sources.size()) sources[current]->rewind();
+    }
+    return false;
+}
+
+void ChainedReplaySource::rewind()
+{
+    current = 0;
+    offsetNanos = 0;
+    lastNanos = 0;
+    if (!sources.empty()) sources[0]->rewind();
+}
+
+bool ChainedReplaySource::isValid() const 
+{
+    for (ReplaySource* source: sources)
+    {
+        if (!source->isValid()) return false;
+    }
+    return true;
+}
+
+double ReplayReport::messagesPerSecond() const 
+{
+    return elapsedNanos ? messages * 1e9 / elapsedNanos : 0.0;
+}
+
+double ReplayReport::bytesPerSecond() const 
+{
+    return elapsedNanos ? bytes * 1e9 / elapsedNanos : 0.0;
+}
+
+namespace 
+{
+    class ReplayCounter: public StaticRxHandler<ReplayCounter>
+    {
+        public:
+            uint64_t messages = 0;
+
+            void standardMessageReceived(Message){ messages++; };
+            void realtimeMessageReceived(Message, Word){ messages++; };
+            void sysExStatusChanged(bool terminated, bool valid)
+            {
+                //Only a SysEx ended by F7 counts as a message
+                if (terminated && valid) messages++;
+            };
+            void sysExByteReceived(Byte){};
+    };
+}
+
+uint64_t ReplayEngine::prepare(ReplaySource& source)
+{
+    //Nothing is recorded while the trace is counted
+    previousMonitor = LatencyMonitor::getActive();
+    LatencyMonitor::attach(nullptr);
+    ReplayCounter counter;
+    ReplayChunk chunk;
+    source.rewind();
+    while (source.next(chunk, UINT64_MAX))
+    {
+        counter.receiveBytes(chunk.data, chunk.length);
+    }
+    if (options.monitor)
+    {
+        options.monitor->reset();
+        LatencyMonitor::attach(options.monitor);
+    }
+    else LatencyMonitor::attach(previousMonitor);
+    return counter.messages;
+}
+
+void ReplayEngine::pace(uint64_t start, uint64_t traceTime, ReplayReport& report)
+{
+    uint64_t due = start + static_cast<uint64_t>(traceTime / options.timeScale());
+    uint64_t now = hostNanos();
+    if (now >= due)
+    {
+        if (now - due > report.maxLagNanos) report.maxLagNanos = now - due;
+        return;
+    }
+    //Sleep most of the way, then spin for accuracy
+    if (due - now > 200000)
+    {
+        uint64_t sleepNanos = due - now - 100000;
+        struct timespec delay = {static_cast<time_t>(sleepNanos / 1000000000), 
+                                 static_cast<long>(sleepNanos % 1000000000)};
+        nanosleep(&delay, nullptr);
+    }
+    while (hostNanos() < due);
+}
+
+void ReplayEngine::finish(ReplayReport& report)
+{
+#if RTMIDI_ENABLE_LATENCY_PROBES
+    if (options.monitor)
+    {
+        for (unsigned int i = 0; i < LatencyStageCount; i++)
+        {
+            report.stages[i] = options.monitor->summary(static_cast<LatencyStage>(i));
+        }
+    }
+#else
+    (void)report;
+#endif
+    LatencyMonitor::attach(previousMonitor);
+}
+
+#endif
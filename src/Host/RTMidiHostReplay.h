@@ -0,0 +1,403 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostReplay.h 
+//!  @brief Replay of recorded byte traces and Standard MIDI Files at full speed or in real time
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_HOST_REPLAY_H_
+#define _RT_MIDI_HOST_REPLAY_H_
+
+#include "../Core/RTMidiCore.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include <stddef.h>
+#include <vector>
+#include "./RTMidiHostStage.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief A read only memory mapping of a whole file.
+     */
+    class MappedFile 
+    {
+        public:
+            MappedFile(): data(nullptr), size(0){};
+            ~MappedFile(){ close(); };
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            /**
+             * @brief Map a file, closing any file already mapped.
+             * 
+             * @return False if the file could not be opened or mapped.  An 
+             *         empty file maps successfully with no data.
+             */
+            bool open(const char* path);
+
+            void close();
+
+            const Byte* getData() const { return data; };
+
+            size_t getSize() const { return size; };
+        protected:
+            const Byte* data;
+            size_t size;
+    };
+
+    /**
+     * @brief A block of bytes to replay.  Every byte in the block is 
+     *        delivered at the time of the first.
+     */
+    struct ReplayChunk 
+    {
+        const Byte* data;
+        unsigned int length;
+        //Time of the first byte since the start of the trace
+        uint64_t timeNanos;
+    };
+
+    /**
+     * @brief Interface class for a trace that can be replayed.
+     */
+    class ReplaySource 
+    {
+        public:
+            virtual ~ReplaySource(){};
+
+            /**
+             * @brief Get the next block of bytes.  The data remains valid 
+             *        until the next call.
+             * 
+             * @param chunk Set to the block
+             * @param maxGapNanos The largest time between the first and 
+             *                    last byte of a block
+             * @return False at the end of the trace
+             */
+            virtual bool next(ReplayChunk& chunk, uint64_t maxGapNanos) = 0;
+
+            /**
+             * @brief Start again from the beginning of the trace.
+             */
+            virtual void rewind() = 0;
+
+            /**
+             * @brief Check the trace was parsed without errors.
+             */
+            virtual bool isValid() const { return true; };
+    };
+
+    /**
+     * @brief Replays a raw byte capture, such as a .syx file or the 
+     *        output of a serial logger, straight from memory.  There are no 
+     *        timestamps, so bytes are spaced at the wire rate.
+     */
+    class RawReplaySource: public ReplaySource 
+    {
+        public:
+            //One byte at 31250 baud with start and stop bits
+            static constexpr uint64_t MidiByteNanos = 320000;
+
+            RawReplaySource(const Byte* data, size_t length, 
+                            unsigned int blockSize = 4096,
+                            uint64_t byteNanos = MidiByteNanos):
+                data(data), length(length), offset(0), 
+                blockSize(blockSize), byteNanos(byteNanos){};
+
+            bool next(ReplayChunk& chunk, uint64_t maxGapNanos) override;
+            void rewind() override { offset = 0; };
+        protected:
+            const Byte* data;
+            size_t length;
+            size_t offset;
+            unsigned int blockSize;
+            uint64_t byteNanos;
+    };
+
+    /**
+     * @brief Replays one direction of a FlightRecorder dump with its 
+     *        recorded timing.
+     */
+    class FlightReplaySource: public ReplaySource 
+    {
+        public:
+            /**
+             * @param data The dump
+             * @param length The length of the dump
+             * @param transmitted True to replay the transmitted bytes 
+             *                    rather than the received bytes
+             */
+            FlightReplaySource(const Byte* data, size_t length, 
+                               bool transmitted = false);
+
+            bool next(ReplayChunk& chunk, uint64_t maxGapNanos) override;
+            void rewind() override;
+            bool isValid() const override { return valid; };
+        protected:
+            const Byte* entries;
+            unsigned int count;
+            unsigned int index;
+            uint64_t ticksPerSecond;
+            uint64_t ticks;
+            bool valid;
+            Byte block[4096];
+    };
+
+    /**
+     * @brief Replays a Standard MIDI File (format 0 or 1) as the byte 
+     *        stream a sequencer would send, with the tracks merged and 
+     *        the tempo map applied.
+     * 
+     *        Every channel message is sent with its status byte.  SysEx 
+     *        events are sent with their F0 byte, escaped (F7) events as 
+     *        they are, and meta events are dropped.
+     */
+    class SmfReplaySource: public ReplaySource 
+    {
+        public:
+            SmfReplaySource(const Byte* data, size_t length, 
+                            unsigned int blockSize = 4096);
+
+            bool next(ReplayChunk& chunk, uint64_t maxGapNanos) override;
+            void rewind() override;
+            bool isValid() const override { return valid; };
+
+            unsigned int getTrackCount() const { return tracks.size(); };
+        protected:
+            struct Track 
+            {
+                const Byte* start;
+                const Byte* end;
+                const Byte* position;
+                uint64_t tick;
+                Byte runningStatus;
+                bool finished;
+            };
+
+            std::vector<Track> tracks;
+            std::vector<Byte> block;
+            unsigned int blockSize;
+            uint16_t division;
+            bool valid;
+
+            uint32_t tempo;
+            uint64_t tempoTick;
+            uint64_t tempoNanos;
+
+            bool readDelta(Track& track);
+            Track* nextTrack();
+            uint64_t tickNanos(uint64_t tick) const;
+            bool emitEvent(Track& track);
+    };
+
+    /**
+     * @brief Replays several sources one after another as one trace, 
+     *        for example every file in a corpus.
+     */
+    class ChainedReplaySource: public ReplaySource 
+    {
+        public:
+            ChainedReplaySource(): current(0), offsetNanos(0), lastNanos(0){};
+
+            void add(ReplaySource& source){ sources.push_back(&source); };
+
+            bool next(ReplayChunk& chunk, uint64_t maxGapNanos) override;
+            void rewind() override;
+            bool isValid() const override;
+        protected:
+            std::vector<ReplaySource*> sources;
+            unsigned int current;
+            uint64_t offsetNanos;
+            uint64_t lastNanos;
+    };
+
+    enum class ReplayMode: Byte 
+    {
+        //As fast as the target can take it
+        Unthrottled,
+        //At the recorded timing
+        RealTime,
+        //At the recorded timing sped up by ReplayOptions::speed
+        Scaled
+    };
+
+    struct ReplayOptions 
+    {
+        ReplayMode mode;
+        //The speed up factor for Scaled.  Must be above 0.
+        double speed;
+        //Times to replay the trace
+        unsigned int loops;
+        //In timed modes, the longest time one block may cover
+        uint64_t maxGapNanos;
+        //Reset and summarised in the report when 
+        //RTMIDI_ENABLE_LATENCY_PROBES is 1
+        LatencyMonitor* monitor;
+
+        ReplayOptions(ReplayMode mode = ReplayMode::Unthrottled, 
+                      double speed = 1.0):
+            mode(mode), speed(speed), loops(1), 
+            maxGapNanos(1000000), monitor(nullptr){};
+
+        /**
+         * @brief Get the factor trace times are divided by.  A Scaled speed
+         *        that is not above 0 replays at the recorded timing.
+         */
+        double timeScale() const 
+        {
+            if ((mode != ReplayMode::Scaled) || !(speed > 0)) return 1.0;
+            return speed;
+        }
+    };
+
+    struct ReplayReport 
+    {
+        uint64_t bytes;
+        uint64_t messages;
+        uint64_t chunks;
+        uint64_t elapsedNanos;
+        //In timed modes, the latest a block was delivered
+        uint64_t maxLagNanos;
+        HistogramSummary stages[LatencyStageCount];
+
+        ReplayReport(): bytes(0), messages(0), chunks(0), 
+                        elapsedNanos(0), maxLagNanos(0), stages(){};
+
+        double messagesPerSecond() const;
+        double bytesPerSecond() const;
+    };
+
+    /**
+     * @brief Pushes a trace into a parser, device or thru graph and 
+     *        measures the sustained throughput.
+     * 
+     *        The target needs receiveBytes(const Byte*, unsigned int, Word), 
+     *        which every RxHandler and StaticRxHandler has.  Blocks are 
+     *        given the trace time in microseconds as their timestamp.
+     * 
+     *        Messages are counted by parsing the trace once before it is 
+     *        replayed, so the count does not depend on the target.
+     */
+    class ReplayEngine 
+    {
+        public:
+            ReplayEngine(const ReplayOptions& options = ReplayOptions()): 
+                options(options){};
+
+            /**
+             * @brief Replay a trace.
+             * 
+             * @param source The trace
+             * @param target The receiver
+             * @param service Called after each block, to process queued 
+             *                messages and drain outputs
+             */
+            template<class TARGET, class SERVICE>
+            ReplayReport run(ReplaySource& source, TARGET& target, SERVICE service)
+            {
+                ReplayReport report;
+                uint64_t messagesPerLoop = prepare(source);
+                bool timed = options.mode != ReplayMode::Unthrottled;
+                uint64_t maxGap = timed ? options.maxGapNanos : UINT64_MAX;
+                uint64_t loopOffset = 0;
+                uint64_t start = hostNanos();
+                for (unsigned int loop = 0; loop < options.loops; loop++)
+                {
+                    ReplayChunk chunk;
+                    uint64_t loopEnd = 0;
+                    source.rewind();
+                    while (source.next(chunk, maxGap))
+                    {
+                        uint64_t traceTime = loopOffset + chunk.timeNanos;
+                        if (timed) pace(start, traceTime, report);
+                        target.receiveBytes(chunk.data, chunk.length, 
+                                            static_cast<Word>(traceTime / 1000));
+                        service();
+                        report.bytes += chunk.length;
+                        report.chunks++;
+                        //The next loop starts after this chunk's bytes
+                        loopEnd = chunk.timeNanos + 
+                                  static_cast<uint64_t>(chunk.length) * 
+                                  MidiLinkSpeed.nanosPerByte();
+                    }
+                    loopOffset += loopEnd;
+                }
+                report.elapsedNanos = hostNanos() - start;
+                report.messages = messagesPerLoop * options.loops;
+                finish(report);
+                return report;
+            }
+
+            template<class TARGET>
+            ReplayReport run(ReplaySource& source, TARGET& target)
+            {
+                return run(source, target, []{});
+            }
+        protected:
+            ReplayOptions options;
+            LatencyMonitor* previousMonitor;
+
+            uint64_t prepare(ReplaySource& source);
+            void pace(uint64_t start, uint64_t traceTime, ReplayReport& report);
+            void finish(ReplayReport& report);
+    };
+}
+
+#endif
+#endif
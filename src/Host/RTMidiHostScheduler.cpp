@@ -0,0 +1,283 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostScheduler.cpp 
+//!  @brief Work stealing scheduler for processing many ports
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiHostScheduler.h"
+
+#if RTMIDI_HOST_LINUX
+
+using namespace RTMIDI;
+
+constexpr Byte PortTask::Pending;
+constexpr Byte PortTask::Running;
+constexpr unsigned int TransmitPortTask::BlockSize;
+
+void TransmitPortTask::run()
+{
+    Byte buffer[BlockSize];
+    while (true)
+    {
+        unsigned int length = 0;
+        int nextByte;
+        while ((length < BlockSize) && ((nextByte = handler.getNextByte()) >= 0))
+        {
+            buffer[length++] = nextByte;
+        }
+        if (length == 0) return;
+        if (sink.writeBytes(buffer, length) < 0) return;
+    }
+}
+
+/**
+ * A worker's queue of ports.  Every port is queued at most once, so a 
+ * queue never holds more than maxPorts ports.
+ */
+struct PortScheduler::Worker 
+{
+    std::thread thread;
+    StageSignal signal;
+    std::atomic_flag lock;
+    std::unique_ptr<PortTask*[]> ports;
+    unsigned int capacity;
+    unsigned int head;
+    unsigned int tail;
+    std::atomic<unsigned int> length;
+    StageCounters counters;
+    std::atomic<uint64_t> stolen;
+
+    Worker(): capacity(0), head(0), tail(0), length(0), stolen(0)
+    {
+        lock.clear();
+    }
+
+    void acquire()
+    {
+        while (lock.test_and_set(std::memory_order_acquire)) 
+        {
+            pollPause(WaitPolicy::BusyPoll);
+        }
+    }
+
+    void release()
+    {
+        lock.clear(std::memory_order_release);
+    }
+};
+
+PortScheduler::PortScheduler(unsigned int count, unsigned int portLimit):
+    workerCount(count ? count : 1),
+    maxPorts(portLimit),
+    portCount(0),
+    waitPolicy(WaitPolicy::Block),
+    firstWorkerCpu(-1),
+    running(false),
+    nextWaker(0),
+    workers(new Worker[workerCount])
+{
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        workers[i].ports.reset(new PortTask*[maxPorts]);
+        workers[i].capacity = maxPorts;
+    }
+}
+
+PortScheduler::~PortScheduler()
+{
+    stop();
+}
+
+bool PortScheduler::addPort(PortTask& port)
+{
+    if (portCount >= maxPorts) return false;
+    port.home = portCount % workerCount;
+    port.state.store(0);
+    portCount++;
+    return true;
+}
+
+bool PortScheduler::start()
+{
+    if (running.exchange(true)) return false;
+    bool pinned = true;
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        workers[i].thread = std::thread(&PortScheduler::workerLoop, this, i);
+        if (firstWorkerCpu >= 0)
+        {
+            pinned &= pinThread(workers[i].thread, firstWorkerCpu + i);
+        }
+    }
+    return pinned;
+}
+
+void PortScheduler::stop()
+{
+    if (!running.exchange(false)) return;
+    for (unsigned int i = 0; i < workerCount; i++) workers[i].signal.notify();
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        if (workers[i].thread.joinable()) workers[i].thread.join();
+    }
+}
+
+void PortScheduler::schedule(PortTask& port)
+{
+    //The read-modify-write orders this after the caller's writes to the 
+    //port, so whichever worker runs the port next will see them.
+    Byte previous = port.state.fetch_or(PortTask::Pending, 
+                                        std::memory_order_acq_rel);
+    //Already queued, or running and will be run again
+    if (previous != 0) return;
+    enqueue(port.home, &port);
+}
+
+void PortScheduler::enqueue(unsigned int index, PortTask* port)
+{
+    Worker& worker = workers[index];
+    worker.acquire();
+    worker.ports[worker.tail] = port;
+    worker.tail = (worker.tail + 1) % worker.capacity;
+    unsigned int backlog = worker.length.fetch_add(1) + 1;
+    worker.release();
+    worker.signal.notify();
+    //Wake another worker to steal if this one has a backlog
+    if ((backlog > 1) && (workerCount > 1))
+    {
+        unsigned int helper = nextWaker.fetch_add(1) % workerCount;
+        if (helper != index) workers[helper].signal.notify();
+    }
+}
+
+PortTask* PortScheduler::dequeue(unsigned int index)
+{
+    Worker& worker = workers[index];
+    if (worker.length.load(std::memory_order_relaxed) == 0) return nullptr;
+    worker.acquire();
+    PortTask* port = nullptr;
+    if (worker.length.load(std::memory_order_relaxed))
+    {
+        port = worker.ports[worker.head];
+        worker.head = (worker.head + 1) % worker.capacity;
+        worker.length.fetch_sub(1);
+    }
+    worker.release();
+    return port;
+}
+
+void PortScheduler::runTask(unsigned int index, PortTask* port)
+{
+    //Exchange rather than store, so that the run sees everything written
+    //before the schedule() calls that queued the port
+    port->state.exchange(PortTask::Running, std::memory_order_acq_rel);
+    port->run();
+    Byte expected = PortTask::Running;
+    if (!port->state.compare_exchange_strong(expected, 0, 
+                                             std::memory_order_acq_rel))
+    {
+        //Scheduled again while running, queue it behind the others
+        port->state.store(PortTask::Pending, std::memory_order_release);
+        enqueue(index, port);
+    }
+}
+
+void PortScheduler::workerLoop(unsigned int index)
+{
+    Worker& self = workers[index];
+    while (running.load(std::memory_order_relaxed))
+    {
+        uint64_t start = hostNanos();
+        unsigned int count = 0;
+        PortTask* port;
+        while ((port = dequeue(index)) != nullptr)
+        {
+            runTask(index, port);
+            count++;
+        }
+        //Steal one port at a time from the other workers
+        for (unsigned int i = 1; (i < workerCount) && !count; i++)
+        {
+            port = dequeue((index + i) % workerCount);
+            if (port)
+            {
+                self.stolen.fetch_add(1, std::memory_order_relaxed);
+                runTask(index, port);
+                count++;
+            }
+        }
+        if (count)
+        {
+            self.counters.recordBatch(count, hostNanos() - start);
+            continue;
+        }
+        self.signal.wait(waitPolicy, 1);
+    }
+}
+
+WorkerStatistics PortScheduler::getStatistics(unsigned int index) const
+{
+    WorkerStatistics stats = {0, 0, 0};
+    if (index >= workerCount) return stats;
+    StageStatistics counters = workers[index].counters.snapshot();
+    stats.tasksRun = counters.items;
+    stats.busyNanos = counters.busyNanos;
+    stats.tasksStolen = workers[index].stolen.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#endif
@@ -0,0 +1,223 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostScheduler.h 
+//!  @brief Work stealing scheduler for processing many ports
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_HOST_SCHEDULER_H_
+#define _RT_MIDI_HOST_SCHEDULER_H_
+
+#include "../Core/RTMidiCore.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include <memory>
+#include "../Output/RTMidiTxHandler.h"
+#include "./RTMidiHostStage.h"
+#include "./RTMidiHostPipeline.h"
+
+namespace RTMIDI 
+{
+    class PortScheduler;
+
+    /**
+     * @brief A unit of port work run by a PortScheduler, such as one 
+     *        device's processMessages().
+     * 
+     *        A task is never run by two workers at once, and a task that is
+     *        scheduled while it runs is run again afterwards, so the work 
+     *        of one port is always done in order.
+     */
+    class PortTask 
+    {
+        friend class PortScheduler;
+        public:
+            PortTask(): state(0), home(0){};
+            virtual ~PortTask(){};
+
+            /**
+             * @brief Do all the work that is waiting for this port.
+             */
+            virtual void run() = 0;
+        private:
+            static constexpr Byte Pending = 0x1;
+            static constexpr Byte Running = 0x2;
+
+            std::atomic<Byte> state;
+            unsigned int home;
+    };
+
+    /**
+     * @brief PortTask that processes an input device's received messages.
+     * 
+     * @tparam DEVICE The input device class
+     */
+    template<class DEVICE>
+    class DevicePortTask: public PortTask 
+    {
+        public:
+            DevicePortTask(DEVICE& inputDevice): device(inputDevice){};
+
+            void run() override 
+            {
+                device.processMessages();
+            }
+        protected:
+            DEVICE& device;
+    };
+
+    /**
+     * @brief PortTask that pumps a TxHandler's bytes into a ByteSink.
+     */
+    class TransmitPortTask: public PortTask 
+    {
+        public:
+            static constexpr unsigned int BlockSize = 64;
+
+            TransmitPortTask(TxHandler& txHandler, ByteSink& byteSink): 
+                handler(txHandler), sink(byteSink){};
+
+            void run() override;
+        protected:
+            TxHandler& handler;
+            ByteSink& sink;
+    };
+
+    /**
+     * @brief Counters for one scheduler worker.
+     */
+    struct WorkerStatistics 
+    {
+        uint64_t tasksRun;
+        uint64_t tasksStolen;
+        uint64_t busyNanos;
+    };
+
+    /**
+     * @brief Runs PortTasks on a pool of worker threads with work stealing.
+     * 
+     *        Every port has a home worker, chosen round robin as ports are 
+     *        added, and schedule() queues the port there so that a port 
+     *        normally stays on one core.  Idle workers steal from the 
+     *        others, so load spreads when some ports are busier than 
+     *        others.  Each worker has its own queue and takes no shared 
+     *        lock unless it steals, so throughput scales with the number 
+     *        of workers.
+     * 
+     *        Call schedule() after giving a port new work (for example 
+     *        after receiveByte() on its device, or after queueing a 
+     *        message to transmit).  It may be called from any thread.
+     */
+    class PortScheduler 
+    {
+        public:
+            /**
+             * @brief Construct a new PortScheduler
+             * 
+             * @param workerCount The number of worker threads
+             * @param maxPorts The most ports that can be added
+             */
+            PortScheduler(unsigned int workerCount, unsigned int maxPorts = 1024);
+            ~PortScheduler();
+
+            /**
+             * @brief Add a port.  Ports must be added before start().
+             * 
+             * @return False if maxPorts ports have already been added
+             */
+            bool addPort(PortTask& port);
+
+            void setWaitPolicy(WaitPolicy policy){ waitPolicy = policy; };
+
+            /**
+             * @brief Pin worker n to CPU firstCpu + n.  Takes effect on start().
+             */
+            void pinWorkers(int firstCpu){ firstWorkerCpu = firstCpu; };
+
+            bool start();
+            void stop();
+
+            /**
+             * @brief Queue a port to run.  Does nothing if it is already 
+             *        queued; if it is running it will run again.
+             */
+            void schedule(PortTask& port);
+
+            unsigned int getWorkerCount() const { return workerCount; };
+
+            WorkerStatistics getStatistics(unsigned int worker) const;
+        protected:
+            struct Worker;
+
+            const unsigned int workerCount;
+            const unsigned int maxPorts;
+            unsigned int portCount;
+            WaitPolicy waitPolicy;
+            int firstWorkerCpu;
+            std::atomic<bool> running;
+            std::atomic<unsigned int> nextWaker;
+            std::unique_ptr<Worker[]> workers;
+
+            void enqueue(unsigned int worker, PortTask* port);
+            PortTask* dequeue(unsigned int worker);
+            void workerLoop(unsigned int worker);
+            void runTask(unsigned int worker, PortTask* port);
+    };
+}
+
+#endif
+#endif
@@ -0,0 +1,178 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostStage.cpp 
+//!  @brief Waiting, pinning and statistics shared by host runtime threads
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiHostStage.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <chrono>
+
+using namespace RTMIDI;
+
+uint64_t RTMIDI::hostNanos()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + now.tv_nsec;
+}
+
+Word RTMIDI::hostMicros()
+{
+    return static_cast<Word>(hostNanos() / 1000);
+}
+
+bool RTMIDI::pinThread(std::thread& thread, int cpu)
+{
+    if (cpu < 0) return true;
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(thread.native_handle(), 
+                                  sizeof(cpus), &cpus) == 0;
+}
+
+void RTMIDI::pollPause(WaitPolicy policy)
+{
+    if (policy == WaitPolicy::Yield) sched_yield();
+    else if (policy == WaitPolicy::BusyPoll)
+    {
+        #if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+        #elif defined(__aarch64__) || defined(__arm__)
+            __asm__ volatile("yield");
+        #endif
+    }
+}
+
+void StageSignal::notify()
+{
+    //Sequentially consistent, so that either this sees the waiter 
+    //sleeping or the waiter sees pending work before it sleeps
+    pending.store(true, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        condition.notify_one();
+    }
+}
+
+void StageSignal::wait(WaitPolicy policy, unsigned int timeoutMillis)
+{
+    if (policy != WaitPolicy::Block)
+    {
+        pollPause(policy);
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.store(true, std::memory_order_seq_cst);
+        condition.wait_for(lock, std::chrono::milliseconds(timeoutMillis),
+                           [this]{ return pending.load(std::memory_order_seq_cst); });
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+    pending.store(false, std::memory_order_relaxed);
+}
+
+void StageCounters::recordBatch(uint64_t count, uint64_t nanos)
+{
+    add(items, count);
+    add(batches, 1);
+    add(busyNanos, nanos);
+}
+
+void StageCounters::recordLatency(uint64_t nanos)
+{
+    add(latencySamples, 1);
+    add(totalLatencyNanos, nanos);
+    if (nanos > maxLatencyNanos.load(std::memory_order_relaxed))
+    {
+        maxLatencyNanos.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+void StageCounters::recordDrop()
+{
+    add(dropped, 1);
+}
+
+StageStatistics StageCounters::snapshot() const
+{
+    StageStatistics stats;
+    stats.items = items.load(std::memory_order_relaxed);
+    stats.batches = batches.load(std::memory_order_relaxed);
+    stats.busyNanos = busyNanos.load(std::memory_order_relaxed);
+    stats.latencySamples = latencySamples.load(std::memory_order_relaxed);
+    stats.totalLatencyNanos = totalLatencyNanos.load(std::memory_order_relaxed);
+    stats.maxLatencyNanos = maxLatencyNanos.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void StageCounters::reset()
+{
+    items.store(0); batches.store(0); busyNanos.store(0);
+    latencySamples.store(0); totalLatencyNanos.store(0);
+    maxLatencyNanos.store(0); dropped.store(0);
+}
+
+#endif
@@ -0,0 +1,197 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostStage.h 
+//!  @brief Waiting, pinning and statistics shared by host runtime threads
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_HOST_STAGE_H_
+#define _RT_MIDI_HOST_STAGE_H_
+
+#include "../Core/RTMidiCore.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace RTMIDI 
+{
+    /**
+     * @brief How a host runtime thread waits for work.
+     */
+    enum class WaitPolicy: Byte 
+    {
+        //Spin on the queue.  Lowest latency, uses a whole core.
+        BusyPoll,
+        //Spin, but give the core away between checks.
+        Yield,
+        //Sleep until signalled.  Costs a wake up per burst of work.
+        Block
+    };
+
+    /**
+     * @brief Get the monotonic host time in nanoseconds.
+     */
+    uint64_t hostNanos();
+
+    /**
+     * @brief Get the monotonic host time in microseconds, as used for 
+     *        message timestamps.
+     */
+    Word hostMicros();
+
+    /**
+     * @brief Pin a thread to one CPU.
+     * 
+     * @param thread The thread
+     * @param cpu The CPU number, or a negative number to leave the thread 
+     *            unpinned
+     * @return False if the thread could not be pinned
+     */
+    bool pinThread(std::thread& thread, int cpu);
+
+    /**
+     * @brief Pause briefly between polls for the BusyPoll and Yield 
+     *        policies.  Does nothing for Block.
+     */
+    void pollPause(WaitPolicy policy);
+
+    /**
+     * @brief Wakes a waiting stage thread when work arrives.
+     * 
+     *        notify() is cheap when the waiting thread is not asleep: it 
+     *        only takes the mutex if the thread is blocked.
+     */
+    class StageSignal 
+    {
+        public:
+            StageSignal(): pending(false), sleeping(false){};
+
+            void notify();
+
+            /**
+             * @brief Wait for notify() according to a wait policy.  
+             *        BusyPoll and Yield return immediately after one pause, 
+             *        Block returns after notify() or the timeout.
+             */
+            void wait(WaitPolicy policy, unsigned int timeoutMillis = 10);
+        protected:
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::atomic<bool> pending;
+            std::atomic<bool> sleeping;
+    };
+
+    /**
+     * @brief A snapshot of a stage's counters.
+     */
+    struct StageStatistics 
+    {
+        //Bytes or messages handled
+        uint64_t items;
+        //Passes that handled at least one item
+        uint64_t batches;
+        //Time spent handling items
+        uint64_t busyNanos;
+        //Latency samples and their sum and maximum
+        uint64_t latencySamples;
+        uint64_t totalLatencyNanos;
+        uint64_t maxLatencyNanos;
+        //Items dropped because the next stage was full
+        uint64_t dropped;
+
+        uint64_t averageLatencyNanos() const 
+        {
+            return latencySamples ? (totalLatencyNanos / latencySamples) : 0;
+        }
+    };
+
+    /**
+     * @brief Counters written by one stage thread and readable from any.
+     */
+    class StageCounters 
+    {
+        public:
+            StageCounters(){ reset(); };
+
+            void recordBatch(uint64_t items, uint64_t busyNanos);
+            void recordLatency(uint64_t nanos);
+            void recordDrop();
+            StageStatistics snapshot() const;
+            void reset();
+        protected:
+            std::atomic<uint64_t> items;
+            std::atomic<uint64_t> batches;
+            std::atomic<uint64_t> busyNanos;
+            std::atomic<uint64_t> latencySamples;
+            std::atomic<uint64_t> totalLatencyNanos;
+            std::atomic<uint64_t> maxLatencyNanos;
+            std::atomic<uint64_t> dropped;
+
+            static void add(std::atomic<uint64_t>& counter, uint64_t value)
+            {
+                //Single writer, so no read-modify-write is needed
+                counter.store(counter.load(std::memory_order_relaxed) + value,
+                              std::memory_order_relaxed);
+            }
+    };
+}
+
+#endif
+#endif
@@ -0,0 +1,443 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostTransport.cpp 
+//!  @brief epoll based I/O for ttys, ptys, FIFOs and sockets
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiHostTransport.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace RTMIDI;
+
+constexpr unsigned int EpollTransport::ReadBlockSize;
+constexpr unsigned int EpollTransport::WriteBlockSize;
+
+//epoll_event data for the wake eventfd, which can never be a port number
+static constexpr uint32_t WakeEvent = UINT32_MAX;
+
+//The most events taken from epoll_wait() at once
+static constexpr int EventBlockSize = 64;
+
+static bool setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0) return false;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static bool setRaw(int fd, speed_t speed)
+{
+    struct termios settings;
+    if (tcgetattr(fd, &settings) != 0) return false;
+    cfmakeraw(&settings);
+    settings.c_cflag |= (CLOCAL | CREAD);
+    settings.c_cflag &= ~(CSTOPB | CRTSCTS);
+    settings.c_cc[VMIN] = 1;
+    settings.c_cc[VTIME] = 0;
+    if (speed != B0)
+    {
+        cfsetispeed(&settings, speed);
+        cfsetospeed(&settings, speed);
+    }
+    return tcsetattr(fd, TCSANOW, &settings) == 0;
+}
+
+static speed_t termiosSpeed(unsigned long baudRate)
+{
+    switch (baudRate)
+    {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B0;
+    }
+}
+
+EpollTransport::EpollTransport(): running(false)
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((epollFd >= 0) && (wakeFd >= 0))
+    {
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = WakeEvent;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    }
+}
+
+EpollTransport::~EpollTransport()
+{
+    for (unsigned int i = 0; i < ports.size(); i++)
+    {
+        if (ports[i]) removePort(i);
+    }
+    if (wakeFd >= 0) close(wakeFd);
+    if (epollFd >= 0) close(epollFd);
+}
+
+int EpollTransport::addPort(int fd, RxHandler* receiver, 
+                            TxHandler* transmitter, bool closeOnRemove)
+{
+    if (!isValid() || (fd < 0)) return -1;
+    if (!setNonBlocking(fd)) return -1;
+
+    unsigned int index = 0;
+    while ((index < ports.size()) && ports[index]) index++;
+    if (index == ports.size()) ports.emplace_back();
+
+    Port* port = new Port;
+    port->fd = fd;
+    port->index = index;
+    port->receiver = receiver;
+    port->transmitter = transmitter;
+    port->ownsFd = closeOnRemove;
+    port->closed = false;
+    port->waitingForWrite = false;
+    port->txOffset = 0;
+    port->txLength = 0;
+
+    //Level triggered, so a port that is not drained in one pass is 
+    //reported again instead of being lost
+    struct epoll_event event;
+    event.events = receiver ? (uint32_t)EPOLLIN : 0;
+    event.data.u32 = index;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        delete port;
+        return -1;
+    }
+    ports[index].reset(port);
+    return index;
+}
+
+void EpollTransport::removePort(int index)
+{
+    if ((index < 0) || (index >= (int)ports.size()) || !ports[index]) return;
+    Port& port = *ports[index];
+    closePort(port);
+    if (port.ownsFd) close(port.fd);
+    ports[index].reset();
+}
+
+bool EpollTransport::isClosed(int index) const
+{
+    if ((index < 0) || (index >= (int)ports.size()) || !ports[index]) return true;
+    return ports[index]->closed;
+}
+
+void EpollTransport::wakeTransmitter(int index)
+{
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        wakeList.push_back(index);
+    }
+    uint64_t one = 1;
+    ssize_t result = write(wakeFd, &one, sizeof(one));
+    (void)result;
+}
+
+int EpollTransport::poll(int timeoutMillis)
+{
+    struct epoll_event events[EventBlockSize];
+    int count = epoll_wait(epollFd, events, EventBlockSize, timeoutMillis);
+    if (count < 0) return (errno == EINTR) ? 0 : -1;
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t index = events[i].data.u32;
+        if (index == WakeEvent)
+        {
+            serviceWakes();
+            continue;
+        }
+        if ((index >= ports.size()) || !ports[index]) continue;
+        Port& port = *ports[index];
+        if (port.closed) continue;
+
+        uint32_t flags = events[i].events;
+        if (flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) readPort(port);
+        if (!port.closed && (flags & EPOLLOUT)) writePort(port);
+        if (!port.closed && (flags & (EPOLLHUP | EPOLLERR))) closePort(port);
+    }
+    return count;
+}
+
+void EpollTransport::run()
+{
+    running.store(true);
+    while (running.load())
+    {
+        if (poll(-1) < 0) break;
+    }
+    running.store(false);
+}
+
+void EpollTransport::stop()
+{
+    running.store(false);
+    uint64_t one = 1;
+    ssize_t result = write(wakeFd, &one, sizeof(one));
+    (void)result;
+}
+
+void EpollTransport::readPort(Port& port)
+{
+    Byte buffer[ReadBlockSize];
+    while (true)
+    {
+        ssize_t length = read(port.fd, buffer, ReadBlockSize);
+        if (length > 0)
+        {
+            if (port.receiver)
+            {
+                port.receiver->receiveBytes(buffer, length, (Word)hostMicros());
+            }
+            //A short read means the descriptor is drained, so skip the 
+            //read that would only return EAGAIN
+            if (length < (ssize_t)ReadBlockSize) return;
+        }
+        else if (length == 0)
+        {
+            closePort(port);
+            return;
+        }
+        else if (errno == EINTR) continue;
+        else
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) closePort(port);
+            return;
+        }
+    }
+}
+
+void EpollTransport::writePort(Port& port)
+{
+    if (!port.transmitter) return;
+
+    while (true)
+    {
+        if (port.txOffset == port.txLength)
+        {
+            port.txOffset = 0;
+            port.txLength = 0;
+            int nextByte;
+            while ((port.txLength < WriteBlockSize) && 
+                   ((nextByte = port.transmitter->getNextByte()) >= 0))
+            {
+                port.txBuffer[port.txLength++] = nextByte;
+            }
+            if (port.txLength == 0)
+            {
+                setWriteWait(port, false);
+                return;
+            }
+        }
+
+        unsigned int remaining = port.txLength - port.txOffset;
+        ssize_t written = write(port.fd, port.txBuffer + port.txOffset, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+                setWriteWait(port, true);
+            }
+            else closePort(port);
+            return;
+        }
+        port.txOffset += written;
+
+        //A short write means the descriptor is full, so wait for EPOLLOUT 
+        //rather than making a write that would only return EAGAIN
+        if ((unsigned int)written < remaining)
+        {
+            setWriteWait(port, true);
+            return;
+        }
+    }
+}
+
+void EpollTransport::setWriteWait(Port& port, bool wait)
+{
+    if (port.waitingForWrite == wait) return;
+    struct epoll_event event;
+    event.events = (port.receiver ? (uint32_t)EPOLLIN : 0) | 
+                   (wait ? (uint32_t)EPOLLOUT : 0);
+    event.data.u32 = port.index;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, port.fd, &event) == 0)
+    {
+        port.waitingForWrite = wait;
+    }
+}
+
+void EpollTransport::closePort(Port& port)
+{
+    if (port.closed) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, port.fd, nullptr);
+    port.closed = true;
+    port.waitingForWrite = false;
+}
+
+void EpollTransport::serviceWakes()
+{
+    uint64_t value;
+    ssize_t result = read(wakeFd, &value, sizeof(value));
+    (void)result;
+
+    wakeWork.clear();
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        wakeWork.swap(wakeList);
+    }
+    for (unsigned int i = 0; i < wakeWork.size(); i++)
+    {
+        int index = wakeWork[i];
+        if ((index < 0) || (index >= (int)ports.size()) || !ports[index]) continue;
+        Port& port = *ports[index];
+        //A port waiting for EPOLLOUT is written when that arrives
+        if (!port.closed && !port.waitingForWrite) writePort(port);
+    }
+}
+
+int EpollTransport::openSerial(const char* path, unsigned long baudRate)
+{
+    speed_t speed = termiosSpeed(baudRate);
+    if (speed == B0) return -1;
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+    if (!setRaw(fd, speed))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool EpollTransport::openPty(int& master, int& slave, 
+                             char* slaveName, unsigned int nameLength)
+{
+    master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master < 0) return false;
+    char name[64];
+    if ((grantpt(master) != 0) || (unlockpt(master) != 0) || 
+        (ptsname_r(master, name, sizeof(name)) != 0))
+    {
+        close(master);
+        return false;
+    }
+    slave = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if ((slave < 0) || !setRaw(slave, B0))
+    {
+        if (slave >= 0) close(slave);
+        close(master);
+        return false;
+    }
+    if (slaveName && nameLength)
+    {
+        strncpy(slaveName, name, nameLength - 1);
+        slaveName[nameLength - 1] = 0;
+    }
+    return true;
+}
+
+int EpollTransport::openFifo(const char* path)
+{
+    if ((mkfifo(path, 0666) != 0) && (errno != EEXIST)) return -1;
+    //Opened for reading and writing so it never reports end of file when 
+    //the other end closes
+    return open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+}
+
+int EpollTransport::connectUnixSocket(const char* path)
+{
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) return -1;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+#endif
@@ -0,0 +1,228 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHostTransport.h 
+//!  @brief epoll based I/O for ttys, ptys, FIFOs and sockets
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_HOST_TRANSPORT_H_
+#define _RT_MIDI_HOST_TRANSPORT_H_
+
+#include "../Core/RTMidiCore.h"
+
+#if RTMIDI_HOST_LINUX
+
+#include "../Input/RTMidiRXHandler.h"
+#include "../Output/RTMidiTxHandler.h"
+#include "./RTMidiHostStage.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Host I/O backend that services many MIDI file descriptors 
+     *        (serial ttys, ptys, FIFOs, pipes and Unix sockets) from one 
+     *        thread with epoll.
+     * 
+     *        Each port is a file descriptor with an optional RxHandler, 
+     *        which is fed whole blocks read from the descriptor, and an 
+     *        optional TxHandler, which is drained into non-blocking 
+     *        writes.  When a write returns EAGAIN the port waits for 
+     *        EPOLLOUT instead of retrying, so a stalled device costs 
+     *        nothing until it can accept data again.
+     * 
+     *        All functions except wakeTransmitter() and stop() must be 
+     *        called from the thread that runs the transport, or before it 
+     *        is started.  Receivers and transmitters are called from that 
+     *        thread.
+     */
+    class EpollTransport 
+    {
+        public:
+            static constexpr unsigned int ReadBlockSize = 1024;
+            static constexpr unsigned int WriteBlockSize = 256;
+
+            EpollTransport();
+            ~EpollTransport();
+
+            /**
+             * @brief Check the epoll instance was created.
+             */
+            bool isValid() const { return (epollFd >= 0) && (wakeFd >= 0); };
+
+            /**
+             * @brief Add a port.  The descriptor is made non-blocking.
+             * 
+             * @param fd The file descriptor
+             * @param receiver (optional) The parser for received bytes
+             * @param transmitter (optional) The source of bytes to write
+             * @param closeOnRemove If true the descriptor is closed when the 
+             *        port is removed or the transport is destroyed
+             * @return The port number, or -1 on error
+             */
+            int addPort(int fd, RxHandler* receiver, TxHandler* transmitter, 
+                        bool closeOnRemove = false);
+
+            /**
+             * @brief Remove a port.  Its port number may be reused.
+             */
+            void removePort(int port);
+
+            /**
+             * @brief Tell a port that its TxHandler has new data.  Safe to 
+             *        call from any thread.
+             */
+            void wakeTransmitter(int port);
+
+            /**
+             * @brief Wait up to timeoutMillis for events and service them.
+             * 
+             * @return The number of events serviced, or -1 on error
+             */
+            int poll(int timeoutMillis);
+
+            /**
+             * @brief Service events until stop() is called.
+             */
+            void run();
+
+            /**
+             * @brief Make run() return.  Safe to call from any thread.
+             */
+            void stop();
+
+            /**
+             * @brief Check whether a port has hung up or failed.  Such 
+             *        ports are no longer polled, but stay until removed.
+             */
+            bool isClosed(int port) const;
+
+            /**
+             * @brief Open a serial tty in raw 8N1 mode.
+             * 
+             * @param path The device path
+             * @param baudRate A standard termios rate.  The MIDI rate of 
+             *        31250 needs a UART driver that maps a standard rate to 
+             *        it, so is not accepted here.
+             * @return The file descriptor, or -1 on error
+             */
+            static int openSerial(const char* path, unsigned long baudRate);
+
+            /**
+             * @brief Open a pseudo terminal pair in raw mode, for connecting 
+             *        to software that expects a serial port, or for testing.
+             * 
+             * @param master Set to the master descriptor
+             * @param slave Set to the slave descriptor
+             * @param slaveName (optional) Filled with the slave's path
+             * @param nameLength The size of slaveName
+             * @return True if the pair was opened
+             */
+            static bool openPty(int& master, int& slave, 
+                                char* slaveName = nullptr, 
+                                unsigned int nameLength = 0);
+
+            /**
+             * @brief Open a FIFO for reading and writing.  The FIFO is 
+             *        created if it does not exist.
+             * 
+             * @return The file descriptor, or -1 on error
+             */
+            static int openFifo(const char* path);
+
+            /**
+             * @brief Connect to a Unix stream socket.
+             * 
+             * @return The file descriptor, or -1 on error
+             */
+            static int connectUnixSocket(const char* path);
+
+        protected:
+            struct Port 
+            {
+                int fd;
+                unsigned int index;
+                RxHandler* receiver;
+                TxHandler* transmitter;
+                bool ownsFd;
+                bool closed;
+                bool waitingForWrite;
+                unsigned int txOffset;
+                unsigned int txLength;
+                Byte txBuffer[WriteBlockSize];
+            };
+
+            int epollFd;
+            int wakeFd;
+            std::atomic<bool> running;
+            std::vector<std::unique_ptr<Port>> ports;
+
+            std::mutex wakeLock;
+            std::vector<int> wakeList;
+            std::vector<int> wakeWork;
+
+            void readPort(Port& port);
+            void writePort(Port& port);
+            void closePort(Port& port);
+            void setWriteWait(Port& port, bool wait);
+            void serviceWakes();
+    };
+}
+
+#endif
+#endif
@@ -62,47 +62,6 @@
 
 using namespace RTMIDI;
 
-#define CALL_LISTENER_FUNCTION(X) \
-    if (listener) listener->X
-
-void InputChannel::sendMessage(Message msg)
-{
-    auto status = msg.getStatus();
-    if (status.appliesToChannel(midiCh))
-    {
-        auto statusCode = status.getStatusCode();
-        bool onOff = false;
-        auto firstByte = msg.getFirstDataByte();
-        auto secondByte = msg.getSecondDataByte();
-        switch(statusCode)
-        {
-            case StatusCode::NoteOn:
-                onOff = true;
-            case StatusCode::NoteOff:
-                CALL_LISTENER_FUNCTION(noteEventReceived(firstByte, 
-                                                         secondByte, 
-                                                         onOff));
-                break;
-            case StatusCode::PolyphonicKeyPressure:
-                CALL_LISTENER_FUNCTION(aftertouchReceived(firstByte, 
-                                                          secondByte));
-                break;
-            case StatusCode::ProgramChange:
-                CALL_LISTENER_FUNCTION(programChangeReceived(firstByte));
-                break;
-            case StatusCode::ControlChange:
-                CALL_LISTENER_FUNCTION(controlChangeReceived(firstByte, 
-                                                             secondByte));
-                break;
-            case StatusCode::ChannelPressure:
-                CALL_LISTENER_FUNCTION(aftertouchReceived(firstByte));
-                break;
-            case StatusCode::PitchBend:
-                CALL_LISTENER_FUNCTION(pitchBendChangeReceived(firstByte,
-                                                               secondByte));
-                break;
-            default:
-                break;
-        }
-    }
-}
\ No newline at end of file
+//The dispatch itself lives in StaticInputChannel, instantiate the virtual 
+//listener version here so it is only compiled once.
+template class RTMIDI::StaticInputChannel<InputChannelListener>;
\ No newline at end of file
@@ -63,9 +63,13 @@
 
 #include "../Core/RTMidiCore.h"
 #include "./RTMidiInputChannelListener.h"
+#include "./RTMidiStaticInputChannel.h"
 
 namespace RTMIDI 
 {
+    //Instantiated once in RTMidiInputChannel.cpp
+    extern template class StaticInputChannel<InputChannelListener>;
+
     /**
      * @brief Class defining a MIDI Input channel.  
      * 
@@ -77,15 +81,16 @@ namespace RTMIDI
      *        also be set to ChOmni to receive messages from all channels, 
      *        or ChNone to receive no messages.
      * 
+     * @see StaticInputChannel for a version without virtual listener calls.
      */
-    class InputChannel
+    class InputChannel: public StaticInputChannel<InputChannelListener>
     {
         public:
             /**
              * @brief Default constructor creates an InputChannel with no 
              *        listener attached and the channel set to ChNone.
              */
-            InputChannel(): listener(nullptr), midiCh(ChNone){};
+            InputChannel(): StaticInputChannel<InputChannelListener>(){};
 
             /**
              * @brief Constructs an input channel with the supplied 
@@ -98,89 +103,26 @@ namespace RTMIDI
              */
             InputChannel(Channel ch, 
                          InputChannelListener* initialListener = nullptr): 
-                listener(initialListener), midiCh(ch){};
-
-            /**
-             * @brief Sends a message to the input channel.  If this channel
-             *        is assigned to a Channel that should receive the message,
-             *        it will forward it appropriately to the InputChannel's
-             *        listener (if attached)
-             * 
-             * @param msg The message to send to the InputChannel
-             */
-            void sendMessage(Message msg);
-            
-            /**
-             * @brief Attaches the provided InputChannelListener object 
-             *        the this InputChannel.
-             * 
-             * @param newListener A pointer to an InputChannelListener object 
-             *                    that should handle events from this channel.
-             */
-            void attachListener(InputChannelListener* newListener)
-            {
-                listener = newListener;
-            }
-
-            /**
-             * @brief Dettaches the currentlty assigned InputChannelListener
-             *        from this InputChannel
-             * 
-             */
-            void dettachListener()
-            {   
-                listener = nullptr;
-            }
-
-            /**
-             * @brief Get this InputChannel's currently assigned MIDI Channel 
-             * 
-             * @return The Channel this InputChannel is assigned to
-             */
-            Channel midiChannel() const { return midiCh; };
-
-            /**
-             * @brief Set this InputChannel's currently assigned MIDI Channel
-             * 
-             * @param ch The Channel to assign this InputChannel to
-             */
-            void setMidiChannel(Channel ch){ midiCh = ch; };
-        protected:
-            /**
-             * @brief The currently attached InputChannelListener object,
-             *        or nullptr if none is attached.
-             */
-            InputChannelListener* listener;
-
-            /**
-             * @brief The currentlty assigned MIDI Channel.
-             */
-            Channel midiCh;
+                StaticInputChannel<InputChannelListener>(ch, initialListener){};
     };
 
-    class InputChannelList 
+    class InputChannelList: public StaticInputChannelList<InputChannel>
     {
         public:
             InputChannelList(InputChannel* channels, 
                              unsigned int listLength = 1):
-                                list(channels), length(listLength){};
+                                StaticInputChannelList<InputChannel>(channels, 
+                                                                     listLength){};
 
             InputChannelList(const InputChannelList& other):
-                list(other.list), length(other.length){};
+                StaticInputChannelList<InputChannel>(other.list, other.length){};
 
-            void dispatchMessage(Message msg)
+            InputChannelList& operator=(const InputChannelList& other)
             {
-                if (length > 0)
-                {
-                    for(unsigned int i = 0; i < length; i++)
-                    {
-                        list[i].sendMessage(msg);
-                    }
-                }
+                list = other.list;
+                length = other.length;
+                return *this;
             }
-        protected:
-            InputChannel* list;
-            unsigned int length;
     };
 }
 #endif
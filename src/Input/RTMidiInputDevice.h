@@ -66,6 +66,7 @@
 #include "./RTMidiMessageReceiver.h"
 #include "./RTMidiRealtimeControllers.h"
 #include "./RTMidiInputChannel.h"
+#include "./RTMidiStateCache.h"
 
 namespace RTMIDI 
 {
@@ -75,25 +76,120 @@ namespace RTMIDI
             GenericInputDevice(InputChannelList devChannels,
                                RealtimeController* realtimeController = nullptr):
                 realtimeCtrl(realtimeController),
-                channels(devChannels){};
+                channels(devChannels),
+                stateCache(nullptr),
+                dispatchList(channels){};
 
             GenericInputDevice(InputChannel* inputChannel,
                                RealtimeController* realtimeController = nullptr):
                 realtimeCtrl(realtimeController),
-                channels(inputChannel, 1){};
+                channels(InputChannelList(inputChannel, 1)),
+                stateCache(nullptr),
+                dispatchList(channels){};
 
             GenericInputDevice(InputChannel* inputChannels,
                                unsigned int noInputChannels,
                                RealtimeController* realtimeController = nullptr):
                 realtimeCtrl(realtimeController),
-                channels(inputChannels, noInputChannels){};
+                channels(InputChannelList(inputChannels, noInputChannels)),
+                stateCache(nullptr),
+                dispatchList(channels){};
 
             void realtimeMessageReceived(Message msg, Word timestamp) override;
             void sysExStatusChanged(bool terminated, bool startedOrValid) override {};
             void sysExByteReceived(Byte byte) override {};   
+
+            /**
+             * @brief Attach a StateCache that will be updated with every 
+             *        channel voice message this device dispatches.
+             * 
+             * @param cache The cache to update, or nullptr to dettach
+             */
+            void attachStateCache(StateCache* cache)
+            {
+                stateCache = cache;
+            }
+
+            void dettachStateCache()
+            {
+                stateCache = nullptr;
+            }
+
+            /**
+             * @brief Replace the input channels messages are dispatched to.
+             * 
+             *        The new list takes effect atomically between two 
+             *        messages, so it is safe to call while the device is 
+             *        receiving.  It must not be called from within a 
+             *        listener of this device.
+             * 
+             *        This is the only way to change channel configuration 
+             *        safely while receiving.  setMidiChannel() and the 
+             *        listener setters change the live InputChannel, which 
+             *        can split a batch between two configurations.  Instead, 
+             *        copy the channels into a second array, change the copy 
+             *        and pass it here.  Give the copy its own batch storage, 
+             *        and only reuse the old array once this returns true 
+             *        again.
+             * 
+             *        A processMessages() pass keeps the list that was live 
+             *        when it dispatched its first message until it has 
+             *        flushed that list's batches, so a new list takes 
+             *        effect from the next pass and no batched message is 
+             *        left behind in the old one.
+             * 
+             * @param newChannels The new channel list
+             * @return False if the previous list is still being dispatched 
+             *         to and nothing was changed.  Try again later.
+             */
+            bool setChannels(InputChannelList newChannels)
+            {
+                InputChannelList* pending = channels.tryEdit();
+                if (!pending) return false;
+                *pending = newChannels;
+                channels.publish();
+                return true;
+            }
+
+            /**
+             * @brief Take a consistent snapshot of the device's counters.  
+             *        Every counter is zero unless RTMIDI_ENABLE_TELEMETRY is 
+             *        1.  Cheap enough to poll often, but must not be called 
+             *        from an interrupt that can preempt the device.
+             */
+            virtual DeviceTelemetry getTelemetry() const 
+            {
+                DeviceTelemetry telemetry;
+                telemetry.clear();
+                readTelemetry(telemetry);
+                return telemetry;
+            }
         protected:
             RealtimeController *const realtimeCtrl;
-            InputChannelList channels;
+            DoubleBuffer<InputChannelList> channels;
+            StateCache* stateCache;
+            DoubleBuffer<InputChannelList>::Reader dispatchList;
+
+            void dispatchChannelVoiceMessage(Message msg)
+            {
+                if (stateCache) stateCache->update(msg);
+                dispatchList.hold().dispatchMessage(msg);
+            }
+
+            void flushChannelBatches()
+            {
+                if (!dispatchList.isHeld()) return;
+                dispatchList.hold().flushBatches();
+                dispatchList.release();
+            }
+
+            /**
+             * @brief Add this device's counters to a snapshot.
+             */
+            virtual void readTelemetry(DeviceTelemetry& telemetry) const 
+            {
+                readRxTelemetry(telemetry);
+            }
     };
 
     template<unsigned int BUFFER_LENGTH, typename BUFFER_INDEX = uint8_t>
@@ -122,9 +218,19 @@ namespace RTMIDI
         protected:
             void processChannelVoiceMessage(Message msg) override
             {
-                channels.dispatchMessage(msg);
+                dispatchChannelVoiceMessage(msg);
             }
             void processSystemCommonMessage(Message msg) override {};
+            void processingComplete() override
+            {
+                flushChannelBatches();
+            }
+
+            void readTelemetry(DeviceTelemetry& telemetry) const override 
+            {
+                GenericInputDevice::readTelemetry(telemetry);
+                this->messageBuffer.readTelemetry(telemetry);
+            }
     };
 }
 #endif
\ No newline at end of file
@@ -62,6 +62,11 @@
 #define _RT_MIDI_INPUT_INPUTS_MASTER_H_
 
 #include "./RTMidiInputChannel.h"
+#include "./RTMidiInputChannelBatchListener.h"
+#include "./RTMidiStateCache.h"
+#include "./RTMidiParameterDecoder.h"
+#include "./RTMidiVoiceAllocator.h"
 #include "./RTMidiInputDevice.h"
+#include "./RTMidiStaticInputDevice.h"
 
 #endif
\ No newline at end of file
@@ -62,31 +62,21 @@
 #define _RT_MIDI_RX_MESSAGE_HANDLER_H_
 
 #include "../Core/RTMidiCore.h"
+#include "./RTMidiStaticMessageReceiver.h"
 
 namespace RTMIDI 
 {
     template<unsigned int LENGTH, typename INDEX_TYPE>
-    class MessageReceiver 
+    class MessageReceiver: 
+        public StaticMessageReceiver<MessageReceiver<LENGTH, INDEX_TYPE>,
+                                     LENGTH, INDEX_TYPE>
     {
-        public:
-            void receiveMessage(Message msg);
-
-            void processMessages()
-            {
-                while(messageBuffer.available())
-                {
-                    Message msg = messageBuffer.read();
-                    if (msg.getStatus().isSystemCommon())
-                    {
-                        this->processSystemCommonMessage(msg);
-                    }
-                    else this->processChannelVoiceMessage(msg);
-                }
-            }
+        friend class StaticMessageReceiver<MessageReceiver<LENGTH, INDEX_TYPE>,
+                                           LENGTH, INDEX_TYPE>;
         protected:
-            MessageBuffer<LENGTH, INDEX_TYPE> messageBuffer;
             virtual void processChannelVoiceMessage(Message msg) = 0;
             virtual void processSystemCommonMessage(Message msg) = 0;
+            virtual void processingComplete(){};
     };
 }
 #endif
\ No newline at end of file
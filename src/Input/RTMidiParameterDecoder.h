@@ -0,0 +1,342 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiParameterDecoder.h 
+//!  @brief RTMIDI ParameterListener and ParameterDecoder class definitions
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_INPUT_PARAMETER_DECODER_H_
+#define _RT_MIDI_INPUT_PARAMETER_DECODER_H_
+
+#include "../Core/RTMidiCore.h"
+#include "./RTMidiInputChannelListener.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Interface class for a class that receives complete 14 bit 
+     *        parameter changes from a ParameterDecoder.
+     */
+    class ParameterListener 
+    {
+        public:
+            /**
+             * @brief Event handler called when a parameter value changes.
+             * 
+             * @param parameter The RPN, NRPN or 14 bit controller that changed
+             * @param value The 14 bit parameter value (0 - 0x3FFF)
+             */
+            virtual void parameterChangeReceived(ParameterNumber parameter, 
+                                                 Word value) = 0;
+
+            /**
+             * @brief Event handler called for a data increment or decrement 
+             *        when the parameter's value is not known, because no 
+             *        data entry has been received since it was selected.
+             * 
+             * @param parameter The RPN or NRPN to step
+             * @param steps +1 for an increment, -1 for a decrement
+             */
+            virtual void parameterStepReceived(ParameterNumber parameter, 
+                                               int steps){};
+    };
+
+    /**
+     * @brief Input channel listener that reassembles RPN, NRPN and 
+     *        (optionally) 14 bit controller sequences.
+     * 
+     *        The decoder sits between an InputChannel and the application's
+     *        listener.  Parameter number select (99/98, 101/100), data entry 
+     *        (6/38) and data increment/decrement (96/97) controllers are 
+     *        consumed and reported to the ParameterListener as whole 
+     *        (parameter, value) events.  All other events are forwarded 
+     *        unchanged to the downstream InputChannelListener.
+     * 
+     *        Selecting a parameter leaves its value unknown until a data 
+     *        entry MSB arrives.  Until then data increment/decrement is 
+     *        reported as a relative step with parameterStepReceived(), and 
+     *        a data entry LSB is held back.  Once the value is known, 
+     *        increment/decrement report the new absolute value.
+     * 
+     *        Data entry MSB resets the value's LSB to zero.  By default a 
+     *        change is reported for both the MSB and the LSB; with 
+     *        setWaitForLsb(true) only the LSB reports a change, which suits
+     *        senders that always transmit both.
+     * 
+     *        Parameter state is kept for one channel, so the decoder should
+     *        be attached to an InputChannel assigned to a single channel.
+     */
+    class ParameterDecoder: public InputChannelListener 
+    {
+        public:
+            static constexpr Byte HighResolutionControllerCount = 32;
+
+            ParameterDecoder(InputChannelListener* downstreamListener = nullptr,
+                             ParameterListener* parameterListener = nullptr):
+                downstream(downstreamListener),
+                paramListener(parameterListener),
+                waitForLsb(false),
+                highResolutionControllers(false)
+            {
+                reset();
+            }
+
+            void attachListener(InputChannelListener* newListener)
+            {
+                downstream = newListener;
+            }
+
+            void attachParameterListener(ParameterListener* newListener)
+            {
+                paramListener = newListener;
+            }
+
+            /**
+             * @brief Only report data entry changes when the LSB arrives.
+             */
+            void setWaitForLsb(bool wait){ waitForLsb = wait; };
+
+            /**
+             * @brief Enable decoding of controllers 0-31 and their LSB 
+             *        controllers 32-63 as 14 bit values.
+             */
+            void enableHighResolutionControllers(bool enable)
+            {
+                highResolutionControllers = enable;
+            }
+
+            /**
+             * @brief Forget the selected parameter and all partial values.
+             */
+            void reset()
+            {
+                selectedType = ParameterType::None;
+                rpnMsb = DataByte::Max; rpnLsb = DataByte::Max;
+                nrpnMsb = DataByte::Max; nrpnLsb = DataByte::Max;
+                valueMsb = 0; valueLsb = 0;
+                valueKnown = false;
+                for (unsigned int i = 0; i < HighResolutionControllerCount; i++)
+                {
+                    controllerMsb[i] = 0;
+                }
+            }
+
+            /**
+             * @brief Get the currently selected RPN or NRPN.
+             */
+            ParameterNumber selectedParameter() const 
+            {
+                switch(selectedType)
+                {
+                    case ParameterType::Registered:
+                        return ParameterNumber(selectedType, 
+                                    DataByte::concatenate(rpnLsb, rpnMsb));
+                    case ParameterType::NonRegistered:
+                        return ParameterNumber(selectedType, 
+                                    DataByte::concatenate(nrpnLsb, nrpnMsb));
+                    default:
+                        return ParameterNumber();
+                }
+            }
+
+            void controlChangeReceived(Byte number, Byte value) override 
+            {
+                if (paramListener && decodeController(number, value)) return;
+                if (downstream) downstream->controlChangeReceived(number, value);
+            }
+
+            void programChangeReceived(Byte number) override 
+            {
+                if (downstream) downstream->programChangeReceived(number);
+            }
+
+            void noteEventReceived(Byte note, Byte velocity, bool noteOn) override
+            {
+                if (downstream) downstream->noteEventReceived(note, velocity, noteOn);
+            }
+
+            void aftertouchReceived(Byte pressure, Byte key = DataByte::Invalid) override
+            {
+                if (downstream) downstream->aftertouchReceived(pressure, key);
+            }
+
+            void pitchBendChangeReceived(Byte lsb, Byte msb) override 
+            {
+                if (downstream) downstream->pitchBendChangeReceived(lsb, msb);
+            }
+
+        protected:
+            InputChannelListener* downstream;
+            ParameterListener* paramListener;
+            bool waitForLsb;
+            bool highResolutionControllers;
+            ParameterType selectedType;
+            Byte rpnMsb;
+            Byte rpnLsb;
+            Byte nrpnMsb;
+            Byte nrpnLsb;
+            Byte valueMsb;
+            Byte valueLsb;
+            //False from selection until a data entry MSB sets the value
+            bool valueKnown;
+            Byte controllerMsb[HighResolutionControllerCount];
+
+            /**
+             * @brief Handle a parameter controller.
+             * 
+             * @return True if the controller was consumed.
+             */
+            bool decodeController(Byte number, Byte value)
+            {
+                switch(static_cast<ControllerNumber>(number))
+                {
+                    case ControllerNumber::NRPNMsb:
+                        nrpnMsb = value;
+                        select(ParameterType::NonRegistered);
+                        return true;
+                    case ControllerNumber::NRPNLsb:
+                        nrpnLsb = value;
+                        select(ParameterType::NonRegistered);
+                        return true;
+                    case ControllerNumber::RPNMsb:
+                        rpnMsb = value;
+                        select(ParameterType::Registered);
+                        return true;
+                    case ControllerNumber::RPNLsb:
+                        rpnLsb = value;
+                        select(ParameterType::Registered);
+                        return true;
+                    case ControllerNumber::DataEntryMsb:
+                        valueMsb = value;
+                        valueLsb = 0;
+                        valueKnown = true;
+                        if (!waitForLsb) reportDataEntry();
+                        return true;
+                    case ControllerNumber::DataEntryLsb:
+                        valueLsb = value;
+                        if (valueKnown) reportDataEntry();
+                        return true;
+                    case ControllerNumber::DataIncrement:
+                        stepDataEntry(1);
+                        return true;
+                    case ControllerNumber::DataDecrement:
+                        stepDataEntry(-1);
+                        return true;
+                    default:
+                        break;
+                }
+                if (!highResolutionControllers) return false;
+                if (number < HighResolutionControllerCount)
+                {
+                    controllerMsb[number] = value;
+                    if (!waitForLsb) reportController(number, 0);
+                    return true;
+                }
+                if (number < 2 * HighResolutionControllerCount)
+                {
+                    reportController(number - HighResolutionControllerCount, value);
+                    return true;
+                }
+                return false;
+            }
+
+            void select(ParameterType type)
+            {
+                selectedType = type;
+                valueMsb = 0;
+                valueLsb = 0;
+                valueKnown = false;
+            }
+
+            void stepDataEntry(int step)
+            {
+                if (!valueKnown)
+                {
+                    ParameterNumber parameter = selectedParameter();
+                    if (!parameter.isNull()) 
+                    {
+                        paramListener->parameterStepReceived(parameter, step);
+                    }
+                    return;
+                }
+                int value = DataByte::concatenate(valueLsb, valueMsb) + step;
+                if (value < 0) value = 0;
+                if (value > static_cast<int>(ParameterNumber::Null)) 
+                {
+                    value = ParameterNumber::Null;
+                }
+                valueMsb = (value >> 7) & DataByte::Max;
+                valueLsb = value & DataByte::Max;
+                reportDataEntry();
+            }
+
+            void reportDataEntry()
+            {
+                ParameterNumber parameter = selectedParameter();
+                if (parameter.isNull()) return;
+                paramListener->parameterChangeReceived(parameter,
+                                    DataByte::concatenate(valueLsb, valueMsb));
+            }
+
+            void reportController(Byte number, Byte lsb)
+            {
+                paramListener->parameterChangeReceived(
+                    ParameterNumber::highResolutionController(number),
+                    DataByte::concatenate(lsb, controllerMsb[number]));
+            }
+    };
+}
+#endif
@@ -62,21 +62,26 @@
 #define _RT_MIDI_RX_RX_HANDLER_H_
 
 #include "../Core/RTMidiCore.h"
+#include "./RTMidiStaticRxHandler.h"
 
 namespace RTMIDI
 {
-    class RxHandler 
+    class RxHandler;
+
+    //Instantiated once in RTMidiRxHandler.cpp
+    extern template class StaticRxHandler<RxHandler>;
+
+    /**
+     * @brief MIDI byte stream parser with virtual message handlers.
+     * 
+     *        This is the runtime polymorphic version of StaticRxHandler.  
+     *        Use StaticRxHandler directly when the receiving class is known 
+     *        at compile time and the virtual call overhead matters.
+     */
+    class RxHandler: public StaticRxHandler<RxHandler>
     {
-        public:
-            void receiveByte(Byte ip, Word timestamp = 0);
-            void receiveMessage(Message msg, Word timestamp = 0);
+        friend class StaticRxHandler<RxHandler>;
         protected:
-            Byte dataByteBuffer;
-            Byte runningStatusBuffer;
-            bool thirdByteExpected;
-            bool sysExInProgress;
-            void processStatusByte(Byte ip, Word timestamp);
-            void processDataByte(Byte ip);
             virtual void standardMessageReceived(Message msg) = 0;
             virtual void realtimeMessageReceived(Message msg, Word timestamp) = 0;
             virtual void sysExStatusChanged(bool terminated, bool startedOrValid) = 0;
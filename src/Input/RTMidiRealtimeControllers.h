@@ -97,6 +97,40 @@ namespace RTMIDI
             virtual void registerClockPulse(Word timestamp){};
     };
 
+    /**
+     * @brief Forward a realtime message to the matching controller 
+     *        function.
+     * 
+     * @tparam CONTROLLER RealtimeController or any class providing the 
+     *                    same member functions.
+     * 
+     * @param ctrl The controller to notify, may be nullptr
+     * @param msg The realtime message
+     * @param timestamp The timestamp provided when the message was received
+     */
+    template<class CONTROLLER>
+    void dispatchRealtimeMessage(CONTROLLER* ctrl, Message msg, Word timestamp)
+    {
+        if (!ctrl) return;
+        switch(msg.getStatus().getSystemCommonCode())
+        {
+            case SystemCommonCode::TimingClock:
+                ctrl->registerClockPulse(timestamp);
+                return;
+            case SystemCommonCode::Start:
+                ctrl->start();
+                return;
+            case SystemCommonCode::Continue:
+                ctrl->resume();
+                return;
+            case SystemCommonCode::Stop:
+                ctrl->stop();
+                return;
+            default:
+                return;
+        }
+    }
+
     // /**
     //  * @brief Abstract class (interface) for a class that 
     //  *        receives control from MIDI clock messages
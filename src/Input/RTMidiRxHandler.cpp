@@ -62,100 +62,6 @@
 
 using namespace RTMIDI;
 
-void RxHandler::receiveByte(Byte ip, Word timestamp)
-{
-    if (DataByte::isStatusByte(ip))
-    {
-        processStatusByte(ip, timestamp);
-    }
-    else processDataByte(ip);
-}
-
-void RxHandler::processStatusByte(Byte ip, Word timestamp)
-{
-    StatusByte status(ip);
-    if (status.isSystemRealtime())
-    {
-        this->realtimeMessageReceived(Message(status), timestamp);
-    }
-    else
-    {
-        if (status.isSystemCommonCode(SystemCommonCode::SysExStart))
-        {
-            sysExInProgress = true;
-            this->sysExStatusChanged(false, true);
-        }
-        else 
-        {
-            sysExInProgress = false;
-            runningStatusBuffer = status;
-            thirdByteExpected = false;
-            this->sysExStatusChanged(true, false);
-            if (status.isSystemCommonCode(SystemCommonCode::TuneRequest))
-            {
-                this->standardMessageReceived(Message(ip));
-            }
-        }
-    }
-}
-
-void RxHandler::processDataByte(Byte ip)
-{
-    if (sysExInProgress)
-    {
-        this->sysExByteReceived(ip);
-        return;
-    }
-    if (thirdByteExpected)
-    {
-        thirdByteExpected = 0;
-        if (runningStatusBuffer >= 0xF0) runningStatusBuffer = 0;
-        Message msg(runningStatusBuffer, dataByteBuffer, ip);
-        this->standardMessageReceived(msg);
-    }
-    else 
-    {
-        if (runningStatusBuffer == 0) return;
-        if (runningStatusBuffer < 0xC0) 
-        {
-            thirdByteExpected = true;
-            dataByteBuffer = ip;
-            return;
-        }
-        else if (runningStatusBuffer < 0xE0)
-        {
-            this->standardMessageReceived(Message(runningStatusBuffer, ip));
-            return;
-        }
-        else if (runningStatusBuffer < 0xF0)
-        {
-            thirdByteExpected = true;
-            dataByteBuffer = ip;
-            return;
-        }
-        else
-        {
-            if (runningStatusBuffer == 0xF2)
-            {
-                thirdByteExpected = true;
-                dataByteBuffer = ip;
-                return;
-            }
-            if (runningStatusBuffer == 0xF3 || runningStatusBuffer == 0xF2)
-            {
-                Message msg(runningStatusBuffer, ip);
-                runningStatusBuffer = 0;
-                this->standardMessageReceived(msg);
-            }
-        }
-    }
-}
-
-void RxHandler::receiveMessage(Message msg, Word timestamp)
-{
-    if (msg.getStatus().isSystemRealtime())
-    {
-        this->realtimeMessageReceived(msg, timestamp);
-    }
-    else this->standardMessageReceived(msg);
-}
\ No newline at end of file
+//The parser itself lives in StaticRxHandler, instantiate the virtual 
+//dispatch version here so it is only compiled once.
+template class RTMIDI::StaticRxHandler<RxHandler>;
\ No newline at end of file
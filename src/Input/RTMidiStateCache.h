@@ -0,0 +1,301 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiStateCache.h 
+//!  @brief RTMIDI ChannelState and StateCache class definitions
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_INPUT_STATE_CACHE_H_
+#define _RT_MIDI_INPUT_STATE_CACHE_H_
+
+#include "../Core/RTMidiCore.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The current state of a single MIDI channel.
+     * 
+     *        The state is updated incrementally from channel voice messages
+     *        and every query is constant time.  Each ChannelState uses 
+     *        276 bytes.
+     */
+    class ChannelState 
+    {
+        public:
+            static constexpr Word PitchBendCenter = 0x2000;
+
+            ChannelState()
+            {
+                reset();
+            }
+
+            /**
+             * @brief Return the channel to its power on state: no notes 
+             *        held, all controllers, program and pressure zero and 
+             *        pitch bend centered.
+             */
+            void reset()
+            {
+                heldNotes.clearAll();
+                for (unsigned int i = 0; i <= DataByte::Max; i++)
+                {
+                    controllers[i] = 0;
+                    velocities[i] = 0;
+                }
+                programNumber = 0;
+                pressure = 0;
+                bendLsb = 0;
+                bendMsb = 0x40;
+            }
+
+            /**
+             * @brief Update the state with a channel voice message.  The 
+             *        message's channel is not checked.
+             * 
+             * @param msg The received message
+             */
+            void update(Message msg)
+            {
+                Byte first = msg.getFirstDataByte() & DataByte::Max;
+                Byte second = msg.getSecondDataByte() & DataByte::Max;
+                switch(msg.getStatus().getStatusCode())
+                {
+                    case StatusCode::NoteOn:
+                        if (second)
+                        {
+                            heldNotes.set(first);
+                            velocities[first] = second;
+                            break;
+                        }
+                        //Note on with zero velocity is a note off
+                    case StatusCode::NoteOff:
+                        heldNotes.clear(first);
+                        velocities[first] = 0;
+                        break;
+                    case StatusCode::ControlChange:
+                        controlChange(first, second);
+                        break;
+                    case StatusCode::ProgramChange:
+                        programNumber = first;
+                        break;
+                    case StatusCode::ChannelPressure:
+                        pressure = first;
+                        break;
+                    case StatusCode::PitchBend:
+                        bendLsb = first;
+                        bendMsb = second;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            Byte controller(Byte number) const 
+            {
+                return controllers[number & DataByte::Max];
+            }
+
+            Byte program() const { return programNumber; };
+
+            Byte channelPressure() const { return pressure; };
+
+            /**
+             * @brief Get the current 14 bit pitch bend value 
+             *        (PitchBendCenter is no bend).
+             */
+            Word pitchBend() const 
+            {
+                return DataByte::concatenate(bendLsb, bendMsb);
+            }
+
+            bool isNoteHeld(Byte note) const 
+            {
+                return heldNotes.test(note);
+            }
+
+            /**
+             * @brief Get the note on velocity of a held note, or 0 if the 
+             *        note is not held.
+             */
+            Byte noteVelocity(Byte note) const 
+            {
+                return velocities[note & DataByte::Max];
+            }
+
+            unsigned int heldNoteCount() const 
+            {
+                return heldNotes.count();
+            }
+
+            /**
+             * @brief Get the lowest held note, or DataByte::Invalid if no 
+             *        notes are held.
+             */
+            Byte firstHeldNote() const 
+            {
+                return heldNotes.lowest();
+            }
+
+            /**
+             * @brief Get the highest held note, or DataByte::Invalid if no 
+             *        notes are held.
+             */
+            Byte lastHeldNote() const 
+            {
+                return heldNotes.highest();
+            }
+
+            const NoteBitmap& getHeldNotes() const 
+            {
+                return heldNotes;
+            }
+
+        protected:
+            NoteBitmap heldNotes;
+            Byte controllers[DataByte::Max + 1];
+            Byte velocities[DataByte::Max + 1];
+            Byte programNumber;
+            Byte pressure;
+            Byte bendLsb;
+            Byte bendMsb;
+
+            void controlChange(Byte number, Byte value)
+            {
+                controllers[number] = value;
+                switch(static_cast<ControllerNumber>(number))
+                {
+                    case ControllerNumber::AllSoundOff:
+                    case ControllerNumber::AllNotesOff:
+                        heldNotes.clearAll();
+                        for (unsigned int i = 0; i <= DataByte::Max; i++)
+                        {
+                            velocities[i] = 0;
+                        }
+                        break;
+                    case ControllerNumber::ResetAllControllers:
+                        resetControllers();
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            void resetControllers()
+            {
+                //Controllers reset as recommended by the MIDI 
+                //Manufacturers Association (RP-015)
+                controllers[static_cast<Byte>(ControllerNumber::ModulationWheel)] = 0;
+                controllers[static_cast<Byte>(ControllerNumber::Expression)] = 
+                    DataByte::Max;
+                for (unsigned int i = 64; i <= 67; i++) controllers[i] = 0;
+                for (unsigned int i = 98; i <= 101; i++) 
+                {
+                    controllers[i] = DataByte::Max;
+                }
+                pressure = 0;
+                bendLsb = 0;
+                bendMsb = 0x40;
+            }
+    };
+
+    /**
+     * @brief Incrementally maintained state of all sixteen MIDI channels.
+     * 
+     *        Attach a StateCache to an input device and it will be updated 
+     *        with every channel voice message before the message is 
+     *        dispatched to the input channels, so listeners and late 
+     *        joining code can read the current state at any time instead 
+     *        of keeping their own copies.  The cache uses about 4.4 KB.
+     */
+    class StateCache 
+    {
+        public:
+            static constexpr unsigned int ChannelCount = 16;
+
+            void update(Message msg)
+            {
+                StatusByte status = msg.getStatus();
+                if (status.getStatusCode() == StatusCode::SystemCommon) return;
+                channels[status.lowNibble()].update(msg);
+            }
+
+            void reset()
+            {
+                for (unsigned int i = 0; i < ChannelCount; i++)
+                {
+                    channels[i].reset();
+                }
+            }
+
+            /**
+             * @brief Get the state of a single channel
+             * 
+             * @param ch The channel (Ch0 - Ch15)
+             */
+            const ChannelState& channel(Channel ch) const 
+            {
+                return channels[ch & 0x0F];
+            }
+
+            const ChannelState& operator[](Channel ch) const 
+            {
+                return channel(ch);
+            }
+        protected:
+            ChannelState channels[ChannelCount];
+    };
+}
+#endif
@@ -0,0 +1,377 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiStaticInputChannel.h 
+//!  @brief RTMIDI StaticInputChannel template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_INPUT_STATIC_INPUT_CHANNEL_H_
+#define _RT_MIDI_INPUT_STATIC_INPUT_CHANNEL_H_
+
+#include "../Core/RTMidiCore.h"
+#include "./RTMidiInputChannelBatchListener.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Base class for statically dispatched input channel listeners.
+     * 
+     *        This provides empty, non-virtual versions of every 
+     *        InputChannelListener event handler.  A listener used with 
+     *        StaticInputChannel inherits from this class and hides only 
+     *        the handlers it is interested in; the rest compile away.
+     */
+    class StaticInputChannelListener 
+    {
+        public:
+            void controlChangeReceived(Byte number, Byte value){};
+            void programChangeReceived(Byte number){};
+            void noteEventReceived(Byte note, Byte velocity, bool noteOn){};
+            void aftertouchReceived(Byte pressure, Byte key){};
+            void pitchBendChangeReceived(Byte lsb, Byte msb){};
+    };
+
+    /**
+     * @brief Input channel that forwards channel voice messages to a 
+     *        listener of type LISTENER.
+     * 
+     *        When LISTENER is a concrete class the listener calls are 
+     *        resolved at compile time and can be inlined.  RTMIDI::InputChannel
+     *        is this class instantiated with the virtual InputChannelListener 
+     *        interface.
+     * 
+     *        A batch listener may also be attached.  Accepted messages are 
+     *        then collected in caller supplied storage and delivered as one 
+     *        span per MIDI Channel when flushBatch() is called, which the 
+     *        input devices do at the end of every processMessages() pass.
+     *        On a ChOmni channel the batch is grouped by MIDI Channel, 
+     *        keeping the arrival order within each group.  Messages of 
+     *        different types on one MIDI Channel are not regrouped, since 
+     *        that would change note and controller semantics; use 
+     *        MessageSpan::runLength() to walk them as runs of one type.
+     * 
+     *        The setters change the live object that messages are being 
+     *        dispatched to, and are not double buffered.  Call them during 
+     *        setup, or from the context that dispatches to the channel.  To 
+     *        reconfigure a channel while its device is receiving, edit a 
+     *        second channel array and swap it in whole with 
+     *        GenericInputDevice::setChannels().
+     * 
+     * @tparam LISTENER The listener class.  It must provide the same event 
+     *                  handlers as InputChannelListener.
+     * @tparam BATCH_LISTENER The batch listener class.  It must provide the 
+     *                        same event handler as InputChannelBatchListener.
+     */
+    template<class LISTENER, 
+             class BATCH_LISTENER = InputChannelBatchListener>
+    class StaticInputChannel
+    {
+        public:
+            /**
+             * @brief Default constructor creates an input channel with no 
+             *        listener attached and the channel set to ChNone.
+             */
+            StaticInputChannel(): listener(nullptr), midiCh(ChNone),
+                                  batchListener(nullptr),
+                                  batchStorage(nullptr),
+                                  batchCapacity(0),
+                                  batchLength(0){};
+
+            /**
+             * @brief Constructs an input channel with the supplied 
+             *        Channel and (optionally) the supplied listener.
+             * 
+             * @param ch The MIDI Channel to assign the input channel to.
+             * 
+             * @param initialListener (optional) The initial listener 
+             *                                   to attatch to the channel.
+             */
+            StaticInputChannel(Channel ch, LISTENER* initialListener = nullptr): 
+                listener(initialListener), midiCh(ch),
+                batchListener(nullptr),
+                batchStorage(nullptr),
+                batchCapacity(0),
+                batchLength(0){};
+
+            /**
+             * @brief Sends a message to the input channel.  If this channel
+             *        is assigned to a Channel that should receive the message,
+             *        it will forward it appropriately to the channel's
+             *        listener (if attached)
+             * 
+             * @param msg The message to send to the input channel
+             */
+            void sendMessage(Message msg)
+            {
+                auto status = msg.getStatus();
+                if (!listener && !batchListener) return;
+                if (!status.appliesToChannel(midiCh)) return;
+                if (batchListener) addToBatch(msg);
+                if (!listener) return;
+                auto firstByte = msg.getFirstDataByte();
+                auto secondByte = msg.getSecondDataByte();
+                switch(status.getStatusCode())
+                {
+                    case StatusCode::NoteOn:
+                        listener->noteEventReceived(firstByte, secondByte, true);
+                        break;
+                    case StatusCode::NoteOff:
+                        listener->noteEventReceived(firstByte, secondByte, false);
+                        break;
+                    case StatusCode::PolyphonicKeyPressure:
+                        listener->aftertouchReceived(secondByte, firstByte);
+                        break;
+                    case StatusCode::ProgramChange:
+                        listener->programChangeReceived(firstByte);
+                        break;
+                    case StatusCode::ControlChange:
+                        listener->controlChangeReceived(firstByte, secondByte);
+                        break;
+                    case StatusCode::ChannelPressure:
+                        listener->aftertouchReceived(firstByte, DataByte::Invalid);
+                        break;
+                    case StatusCode::PitchBend:
+                        listener->pitchBendChangeReceived(firstByte, secondByte);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            /**
+             * @brief Attaches the provided listener object to this channel.
+             * 
+             * @param newListener A pointer to the listener object that 
+             *                    should handle events from this channel.
+             */
+            void attachListener(LISTENER* newListener)
+            {
+                listener = newListener;
+            }
+
+            /**
+             * @brief Dettaches the currentlty assigned listener from this 
+             *        channel.
+             */
+            void dettachListener()
+            {   
+                listener = nullptr;
+            }
+
+            /**
+             * @brief Get this channel's currently assigned MIDI Channel 
+             * 
+             * @return The Channel this input channel is assigned to
+             */
+            Channel midiChannel() const { return midiCh; };
+
+            /**
+             * @brief Set this channel's currently assigned MIDI Channel
+             * 
+             * @param ch The Channel to assign this input channel to
+             */
+            void setMidiChannel(Channel ch){ midiCh = ch; };
+
+            /**
+             * @brief Attaches a batch listener to this channel.
+             * 
+             *        Accepted messages are stored in the supplied array until
+             *        the next call to flushBatch().  If the array fills up 
+             *        before then, the messages collected so far are delivered 
+             *        early so that nothing is lost or reordered.
+             * 
+             * @param newListener The batch listener
+             * @param storage An array of at least "capacity" messages
+             * @param capacity The length of the storage array
+             */
+            void attachBatchListener(BATCH_LISTENER* newListener, 
+                                     Message* storage, 
+                                     Byte capacity)
+            {
+                flushBatch();
+                batchStorage = storage;
+                batchCapacity = capacity;
+                batchListener = (storage && capacity) ? newListener : nullptr;
+            }
+
+            /**
+             * @brief Delivers any pending messages and dettaches the 
+             *        current batch listener.
+             */
+            void dettachBatchListener()
+            {
+                flushBatch();
+                batchListener = nullptr;
+            }
+
+            /**
+             * @brief Delivers the messages collected since the last flush 
+             *        to the batch listener, one span per MIDI Channel.
+             */
+            void flushBatch()
+            {
+                if (batchLength == 0) return;
+                if (batchListener)
+                {
+                    if (midiCh == ChOmni)
+                    {
+                        Byte start = 0;
+                        while (start < batchLength)
+                        {
+                            Byte count = groupChannel(start);
+                            batchListener->messageBatchReceived(
+                                        batchStorage[start].getStatus().getChannel(), 
+                                        MessageSpan(batchStorage + start, count));
+                            start = start + count;
+                        }
+                    }
+                    else 
+                    {
+                        batchListener->messageBatchReceived(midiCh, 
+                                        MessageSpan(batchStorage, batchLength));
+                    }
+                }
+                batchLength = 0;
+            }
+        protected:
+            /**
+             * @brief The currently attached listener object,
+             *        or nullptr if none is attached.
+             */
+            LISTENER* listener;
+
+            /**
+             * @brief The currentlty assigned MIDI Channel.
+             */
+            Channel midiCh;
+
+            /**
+             * @brief The currently attached batch listener, or nullptr.
+             */
+            BATCH_LISTENER* batchListener;
+
+            Message* batchStorage;
+            Byte batchCapacity;
+            Byte batchLength;
+
+            void addToBatch(Message msg)
+            {
+                if (batchLength >= batchCapacity) flushBatch();
+                batchStorage[batchLength] = msg;
+                batchLength = batchLength + 1;
+            }
+
+            /**
+             * @brief Move the later messages on the same MIDI Channel as the 
+             *        message at start up to follow it, keeping their order.
+             * 
+             * @param start The index of the first message of the group
+             * @return The number of messages in the group
+             */
+            Byte groupChannel(Byte start)
+            {
+                Channel ch = batchStorage[start].getStatus().getChannel();
+                Byte end = start + 1;
+                for (Byte i = end; i < batchLength; i++)
+                {
+                    if (batchStorage[i].getStatus().getChannel() != ch) continue;
+                    Message msg = batchStorage[i];
+                    for (Byte j = i; j > end; j--)
+                    {
+                        batchStorage[j] = batchStorage[j - 1];
+                    }
+                    batchStorage[end] = msg;
+                    end = end + 1;
+                }
+                return end - start;
+            }
+    };
+
+    /**
+     * @brief A list of input channels of type CHANNEL that messages are 
+     *        dispatched to in order.
+     * 
+     * @tparam CHANNEL The input channel class
+     */
+    template<class CHANNEL>
+    class StaticInputChannelList 
+    {
+        public:
+            StaticInputChannelList(CHANNEL* channels, 
+                                   unsigned int listLength = 1):
+                                        list(channels), length(listLength){};
+
+            void dispatchMessage(Message msg) const
+            {
+                for(unsigned int i = 0; i < length; i++)
+                {
+                    list[i].sendMessage(msg);
+                }
+            }
+
+            void flushBatches() const
+            {
+                for(unsigned int i = 0; i < length; i++)
+                {
+                    list[i].flushBatch();
+                }
+            }
+        protected:
+            CHANNEL* list;
+            unsigned int length;
+    };
+}
+#endif
@@ -0,0 +1,151 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiStaticInputDevice.h 
+//!  @brief RTMIDI StaticInputDevice template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_INPUT_STATIC_INPUT_DEVICE_H_
+#define _RT_MIDI_INPUT_STATIC_INPUT_DEVICE_H_
+
+#include "../Core/RTMidiCore.h"
+#include "./RTMidiStaticRxHandler.h"
+#include "./RTMidiStaticMessageReceiver.h"
+#include "./RTMidiStaticInputChannel.h"
+#include "./RTMidiRealtimeControllers.h"
+#include "./RTMidiStateCache.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Input device with the whole receive path statically dispatched.
+     * 
+     *        This is the compile time counterpart of InputDevice.  Parsing, 
+     *        buffering and dispatch to the LISTENER class are all resolved 
+     *        at compile time, so for a fixed device configuration the 
+     *        compiler can inline everything from receiveByte() to the 
+     *        listener's event handlers.
+     * 
+     * @tparam LISTENER The input channel listener class
+     * @tparam BUFFER_LENGTH The length of the received message buffer
+     * @tparam BUFFER_INDEX The received message buffer index type
+     * @tparam CONTROLLER The realtime controller class
+     */
+    template<class LISTENER, 
+             unsigned int BUFFER_LENGTH, 
+             typename BUFFER_INDEX = uint8_t,
+             class CONTROLLER = RealtimeController>
+    class StaticInputDevice: 
+        public StaticRxHandler<StaticInputDevice<LISTENER, BUFFER_LENGTH, 
+                                                 BUFFER_INDEX, CONTROLLER>>,
+        public StaticMessageReceiver<StaticInputDevice<LISTENER, BUFFER_LENGTH,
+                                                       BUFFER_INDEX, CONTROLLER>,
+                                     BUFFER_LENGTH, BUFFER_INDEX>
+    {
+        public:
+            typedef StaticInputChannel<LISTENER> InputChannelType;
+
+            StaticInputDevice(InputChannelType* inputChannels,
+                              unsigned int noInputChannels = 1,
+                              CONTROLLER* realtimeController = nullptr):
+                realtimeCtrl(realtimeController),
+                channels(inputChannels, noInputChannels),
+                stateCache(nullptr){};
+
+            void standardMessageReceived(Message msg)
+            {
+                this->messageBuffer.push(msg);
+            }
+
+            void realtimeMessageReceived(Message msg, Word timestamp)
+            {
+                dispatchRealtimeMessage(realtimeCtrl, msg, timestamp);
+            }
+
+            void sysExStatusChanged(bool terminated, bool startedOrValid){};
+
+            void sysExByteReceived(Byte byte){};
+
+            void processChannelVoiceMessage(Message msg)
+            {
+                if (stateCache) stateCache->update(msg);
+                channels.dispatchMessage(msg);
+            }
+
+            void processSystemCommonMessage(Message msg){};
+
+            void processingComplete()
+            {
+                channels.flushBatches();
+            }
+
+            /**
+             * @brief Attach a StateCache that will be updated with every 
+             *        channel voice message this device dispatches.
+             * 
+             * @param cache The cache to update, or nullptr to dettach
+             */
+            void attachStateCache(StateCache* cache)
+            {
+                stateCache = cache;
+            }
+        protected:
+            CONTROLLER *const realtimeCtrl;
+            StaticInputChannelList<InputChannelType> channels;
+            StateCache* stateCache;
+    };
+}
+#endif
@@ -0,0 +1,162 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiStaticMessageReceiver.h 
+//!  @brief RTMIDI StaticMessageReceiver template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_RX_STATIC_MESSAGE_RECEIVER_H_
+#define _RT_MIDI_RX_STATIC_MESSAGE_RECEIVER_H_
+
+#include "../Core/RTMidiCore.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Statically dispatched message buffer consumer.
+     * 
+     *        Messages stored in the messageBuffer are removed by 
+     *        processMessages() and handed to the DERIVED class, which 
+     *        must provide (publicly or with this class as a friend):
+     * 
+     *          void processChannelVoiceMessage(Message msg);
+     *          void processSystemCommonMessage(Message msg);
+     * 
+     *        It may also provide processingComplete(), which is called once 
+     *        after each pass of processMessages() that handled at least one 
+     *        message. 
+     *        RTMIDI::MessageReceiver is the virtual dispatch version.
+     * 
+     * @tparam DERIVED The class inheriting from StaticMessageReceiver
+     * @tparam LENGTH The length of the message buffer
+     * @tparam INDEX_TYPE The message buffer index type
+     */
+    template<class DERIVED, unsigned int LENGTH, typename INDEX_TYPE>
+    class StaticMessageReceiver 
+    {
+        public:
+            /**
+             * @brief Process all messages currently waiting in the 
+             *        message buffer.
+             */
+            void processMessages()
+            {
+                if (!messageBuffer.available()) return;
+                while(messageBuffer.available())
+                {
+                    Message msg = messageBuffer.popTimed(LatencyStage::Queue);
+                #if RTMIDI_ENABLE_LATENCY_PROBES
+                    Word dequeued = LatencyMonitor::now();
+                #endif
+                    if (msg.getStatus().isSystemCommon())
+                    {
+                        derived().processSystemCommonMessage(msg);
+                    }
+                    else derived().processChannelVoiceMessage(msg);
+                #if RTMIDI_ENABLE_LATENCY_PROBES
+                    LatencyMonitor::record(LatencyStage::Listener, dequeued);
+                #endif
+                }
+                derived().processingComplete();
+            }
+
+            /**
+             * @brief Attach a notifier that is woken when messages arrive 
+             *        in the empty message buffer, for use with 
+             *        waitForMessages().
+             * 
+             * @param notifier The notifier, or nullptr to detach
+             */
+            void setNotifier(BufferNotifier* notifier)
+            {
+                messageBuffer.setNotifier(notifier);
+            }
+
+            /**
+             * @brief Sleep until the message buffer is not empty.
+             * 
+             *        A consumer thread or main loop can alternate this with 
+             *        processMessages() to sleep while idle.  Without a 
+             *        notifier it does not wait.
+             * 
+             * @param timeoutMillis The longest time to wait, or -1 for no 
+             *        timeout
+             * @return True if there are messages to process
+             */
+            bool waitForMessages(int timeoutMillis = -1)
+            {
+                BufferNotifier* notifier = messageBuffer.getNotifier();
+                while (!messageBuffer.hasItems())
+                {
+                    if (!notifier || !notifier->wait(timeoutMillis))
+                    {
+                        return messageBuffer.hasItems();
+                    }
+                }
+                return true;
+            }
+        protected:
+            MessageBuffer<LENGTH, INDEX_TYPE> messageBuffer;
+
+            void processingComplete(){};
+
+            DERIVED& derived()
+            {
+                return *static_cast<DERIVED*>(this);
+            }
+    };
+}
+#endif
@@ -0,0 +1,543 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiStaticRxHandler.h 
+//!  @brief RTMIDI StaticRxHandler template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_RX_STATIC_RX_HANDLER_H_
+#define _RT_MIDI_RX_STATIC_RX_HANDLER_H_
+
+#include "../Core/RTMidiCore.h"
+
+namespace RTMIDI
+{
+    /**
+     * @brief How StaticRxHandler recovers from a malformed byte stream.
+     * 
+     *        In both modes a status byte always starts a new message, a 
+     *        message interrupted by a status byte is discarded, data bytes 
+     *        with no status to apply to are dropped, and the undefined 
+     *        realtime bytes (F9, FD) are dropped.
+     */
+    enum class ParserMode: Byte 
+    {
+        //Bytes the MIDI specification says to ignore (F4, F5, and F7 
+        //outside a SysEx) are ignored: running status and any message 
+        //being parsed survive them.
+        Lenient,
+        //Those bytes cancel running status and the message being parsed, 
+        //so data bytes are dropped until the next status byte rather than 
+        //risk being parsed out of step.  F4 or F5 inside a SysEx aborts it.
+        Strict
+    };
+
+    /**
+     * @brief The malformed sequences StaticRxHandler counts.
+     */
+    enum class ParserError: Byte 
+    {
+        //A data byte with no status byte to apply to
+        OrphanData = 0,
+        //A status byte before the previous message's data was complete
+        InterruptedMessage = 1,
+        //One of the undefined status bytes F4, F5, F9 or FD
+        UndefinedStatus = 2,
+        //An End of Exclusive (F7) with no SysEx in progress
+        UnexpectedSysExEnd = 3,
+        //A SysEx ended by a status byte other than F7
+        AbortedSysEx = 4
+    };
+
+    constexpr unsigned int ParserErrorCount = 5;
+
+    /**
+     * @brief Statically dispatched MIDI byte stream parser.
+     * 
+     *        StaticRxHandler implements the MIDI receive state machine and 
+     *        reports parsed messages to the DERIVED class through the 
+     *        curiously recurring template pattern.  Because the calls are 
+     *        resolved at compile time, the whole path from receiveByte() 
+     *        to the derived class's handlers can be inlined.
+     * 
+     *        The DERIVED class must provide the following member functions
+     *        (StaticRxHandler must be able to access them, so either make 
+     *        them public or declare StaticRxHandler<DERIVED> a friend):
+     * 
+     *          void standardMessageReceived(Message msg);
+     *          void realtimeMessageReceived(Message msg, Word timestamp);
+     *          void sysExStatusChanged(bool terminated, bool startedOrValid);
+     *          void sysExByteReceived(Byte byte);
+     * 
+     *        RTMIDI::RxHandler is this parser instantiated with virtual 
+     *        handlers, for use when runtime polymorphism is required.
+     * 
+     * @tparam DERIVED The class inheriting from StaticRxHandler
+     */
+    template<class DERIVED>
+    class StaticRxHandler 
+    {
+        public:
+            /**
+             * @brief Construct a new StaticRxHandler with no running status.
+             */
+            StaticRxHandler(): dataByteBuffer(0), 
+                               runningStatusBuffer(0),
+                               thirdByteExpected(false),
+                               sysExInProgress(false),
+                               statusPending(false),
+                               parserMode(ParserMode::Lenient),
+                               errorCounts()
+                            #if RTMIDI_ENABLE_TELEMETRY
+                               , telemetryFreshStatus(false)
+                               , telemetryRunningStatus(false)
+                               , telemetryCompleted(MessageTypeCount)
+                            #endif
+                            #if RTMIDI_ENABLE_LATENCY_PROBES
+                               , probeMessageStart(0)
+                            #endif
+                            #if RTMIDI_ENABLE_FLIGHT_RECORDER
+                               , flightRecorder(nullptr)
+                            #endif
+                               {};
+
+            /**
+             * @brief Process a single byte received from the MIDI stream.
+             * 
+             *        This function will normally be called from an interrupt.
+             * 
+             * @param ip The received byte
+             * @param timestamp (optional) The time the byte was received. The 
+             *                  units or reference point are implementation 
+             *                  specific.
+             */
+            void receiveByte(Byte ip, Word timestamp = 0)
+            {
+            #if RTMIDI_ENABLE_FLIGHT_RECORDER
+                if (flightRecorder) flightRecorder->recordReceived(ip);
+            #endif
+            #if RTMIDI_ENABLE_LATENCY_PROBES
+                stampMessageStart(ip);
+            #endif
+            #if RTMIDI_ENABLE_TELEMETRY
+                unsigned int counter = classifyByte(ip);
+            #endif
+                if (DataByte::isStatusByte(ip))
+                {
+                    processStatusByte(ip, timestamp);
+                }
+                else processDataByte(ip);
+            #if RTMIDI_ENABLE_TELEMETRY
+                countByte(counter);
+            #endif
+            }
+
+            /**
+             * @brief Process a block of bytes received from the MIDI stream.
+             * 
+             *        This is for transports that receive data in blocks 
+             *        (USB, host file descriptors) rather than one byte per 
+             *        interrupt.  All bytes are given the same timestamp.
+             * 
+             * @param data The received bytes
+             * @param length The number of bytes
+             * @param timestamp (optional) The time the block was received
+             */
+            void receiveBytes(const Byte* data, unsigned int length, 
+                              Word timestamp = 0)
+            {
+                for (unsigned int i = 0; i < length; i++)
+                {
+                    receiveByte(data[i], timestamp);
+                }
+            }
+
+            /**
+             * @brief Process an already parsed message as if it had been 
+             *        received from the MIDI stream.
+             * 
+             * @param msg The received message
+             * @param timestamp (optional) The time the message was received
+             */
+            void receiveMessage(Message msg, Word timestamp = 0)
+            {
+                if (msg.getStatus().isSystemRealtime())
+                {
+                    derived().realtimeMessageReceived(msg, timestamp);
+                }
+                else derived().standardMessageReceived(msg);
+            }
+
+            /**
+             * @brief Abort the SysEx in progress, as if a status byte other 
+             *        than F7 had been received.  This is for transports 
+             *        that know part of a SysEx was lost.
+             */
+            void abortSysEx()
+            {
+                if (!sysExInProgress) return;
+                sysExInProgress = false;
+                countError(ParserError::AbortedSysEx);
+                derived().sysExStatusChanged(true, false);
+            }
+
+            /**
+             * @brief Add the parser's counters to a snapshot.  Nothing is 
+             *        added unless RTMIDI_ENABLE_TELEMETRY is 1.
+             */
+            void readRxTelemetry(DeviceTelemetry& snapshot) const 
+            {
+            #if RTMIDI_ENABLE_TELEMETRY
+                rxTelemetry.readInto(snapshot);
+            #endif
+            }
+
+            /**
+             * @brief Choose how the parser recovers from a malformed stream.
+             */
+            void setParserMode(ParserMode mode){ parserMode = mode; };
+
+            ParserMode getParserMode() const { return parserMode; };
+
+            /**
+             * @brief Get the number of times an error has been seen since 
+             *        the parser was created or clearErrors() was called.
+             */
+            Word getErrorCount(ParserError error) const 
+            {
+                return errorCounts[static_cast<Byte>(error)];
+            }
+
+            Word getTotalErrors() const 
+            {
+                Word total = 0;
+                for (unsigned int i = 0; i < ParserErrorCount; i++) total += errorCounts[i];
+                return total;
+            }
+
+            /**
+             * @brief Reset the error counts.  An error counted by an 
+             *        interrupt during the reset may be lost.
+             */
+            void clearErrors()
+            {
+                for (unsigned int i = 0; i < ParserErrorCount; i++) errorCounts[i] = 0;
+            }
+
+            /**
+             * @brief Record every received byte.  Nothing is recorded 
+             *        unless RTMIDI_ENABLE_FLIGHT_RECORDER is 1.
+             * 
+             * @param recorder The recorder, or nullptr to stop recording
+             */
+            void attachFlightRecorder(FlightRecorder* recorder)
+            {
+            #if RTMIDI_ENABLE_FLIGHT_RECORDER
+                flightRecorder = recorder;
+            #else
+                (void)recorder;
+            #endif
+            }
+
+        protected:
+            Byte dataByteBuffer;
+            Byte runningStatusBuffer;
+            bool thirdByteExpected;
+            bool sysExInProgress;
+            //A status byte has arrived but none of its data bytes
+            bool statusPending;
+            ParserMode parserMode;
+            volatile Word errorCounts[ParserErrorCount];
+        #if RTMIDI_ENABLE_TELEMETRY
+            RxTelemetry rxTelemetry;
+            //Whether the message being parsed had its own status byte
+            bool telemetryFreshStatus;
+            //The message completed by the byte being processed
+            bool telemetryRunningStatus;
+            unsigned int telemetryCompleted;
+
+            /**
+             * @brief Get the counter a byte adds to besides Bytes, from the 
+             *        state before it is parsed.
+             */
+            unsigned int classifyByte(Byte ip)
+            {
+                //Undefined status bytes are dropped, so are not messages
+                if ((ip == 0xF4) || (ip == 0xF5) || (ip == 0xF9) || (ip == 0xFD))
+                {
+                    return RxTelemetry::UndefinedStatusBytes;
+                }
+                if (ip >= StatusByte::SystemRealtimeMin) return RxTelemetry::RealtimeBytes;
+                if (DataByte::isStatusByte(ip))
+                {
+                    telemetryFreshStatus = true;
+                    return RxTelemetry::Bytes;
+                }
+                if (sysExInProgress) return RxTelemetry::SysExBytes;
+                if (thirdByteExpected) return RxTelemetry::Bytes;
+                //The data bytes the parser has no status to apply to
+                return (runningStatusBuffer == 0) ? RxTelemetry::OrphanDataBytes : 
+                                                    RxTelemetry::Bytes;
+            }
+
+            /**
+             * @brief Count a parsed byte, and any message it completed, in 
+             *        one update so that snapshots never see one without the 
+             *        other.
+             */
+            void countByte(unsigned int counter)
+            {
+                rxTelemetry.beginWrite();
+                rxTelemetry.add(RxTelemetry::Bytes);
+                if (counter != RxTelemetry::Bytes) rxTelemetry.add(counter);
+                if (counter == RxTelemetry::RealtimeBytes)
+                {
+                    rxTelemetry.add(RxTelemetry::Messages + 
+                                    messageTypeIndex(StatusByte::SystemRealtimeMin));
+                }
+                if (telemetryCompleted < MessageTypeCount)
+                {
+                    rxTelemetry.add(RxTelemetry::Messages + telemetryCompleted);
+                    if (telemetryRunningStatus) 
+                    {
+                        rxTelemetry.add(RxTelemetry::RunningStatusHits);
+                    }
+                    telemetryCompleted = MessageTypeCount;
+                }
+                rxTelemetry.endWrite();
+            }
+        #endif
+        #if RTMIDI_ENABLE_LATENCY_PROBES
+            //When the first byte of the message being parsed arrived
+            Word probeMessageStart;
+
+            void stampMessageStart(Byte ip)
+            {
+                if (ip >= StatusByte::SystemRealtimeMin) return;
+                if (DataByte::isStatusByte(ip))
+                {
+                    //SysEx bytes are not messages, so are not timed
+                    bool sysEx = (ip == 0xF0) || (ip == 0xF7);
+                    probeMessageStart = sysEx ? 0 : LatencyMonitor::now();
+                }
+                else if ((probeMessageStart == 0) && !sysExInProgress)
+                {
+                    //The first data byte of a running status message
+                    probeMessageStart = LatencyMonitor::now();
+                }
+            }
+        #endif
+        #if RTMIDI_ENABLE_FLIGHT_RECORDER
+            FlightRecorder* volatile flightRecorder;
+        #endif
+
+            /**
+             * @brief Hand a parsed message to the DERIVED class.
+             */
+            void messageComplete(Message msg)
+            {
+            #if RTMIDI_ENABLE_LATENCY_PROBES
+                LatencyMonitor::record(LatencyStage::Parse, probeMessageStart);
+                probeMessageStart = 0;
+            #endif
+            #if RTMIDI_ENABLE_TELEMETRY
+                //Counted with the byte that completed it
+                telemetryCompleted = messageTypeIndex(msg.getByte(0));
+                telemetryRunningStatus = !telemetryFreshStatus;
+                telemetryFreshStatus = false;
+            #endif
+                derived().standardMessageReceived(msg);
+            }
+
+            DERIVED& derived()
+            {
+                return *static_cast<DERIVED*>(this);
+            }
+
+            void processStatusByte(Byte ip, Word timestamp)
+            {
+                if (ip >= StatusByte::SystemRealtimeMin)
+                {
+                    if ((ip == 0xF9) || (ip == 0xFD))
+                    {
+                        //Ignored like any realtime byte, so no state changes
+                        countError(ParserError::UndefinedStatus);
+                        return;
+                    }
+                    derived().realtimeMessageReceived(Message(StatusByte(ip)), timestamp);
+                    return;
+                }
+                if ((ip == 0xF4) || (ip == 0xF5) || 
+                    ((ip == 0xF7) && !sysExInProgress))
+                {
+                    countError((ip == 0xF7) ? ParserError::UnexpectedSysExEnd : 
+                                              ParserError::UndefinedStatus);
+                    //Lenient parsing ignores the byte altogether
+                    if (parserMode == ParserMode::Lenient) return;
+                    if (sysExInProgress)
+                    {
+                        sysExInProgress = false;
+                        countError(ParserError::AbortedSysEx);
+                        derived().sysExStatusChanged(true, false);
+                    }
+                    else if (statusPending || thirdByteExpected)
+                    {
+                        countError(ParserError::InterruptedMessage);
+                    }
+                    resynchronise();
+                    return;
+                }
+                if (sysExInProgress)
+                {
+                    //Only an End of Exclusive completes the SysEx, any 
+                    //other status byte aborts it
+                    bool sysExValid = (ip == 0xF7);
+                    sysExInProgress = false;
+                    if (!sysExValid) countError(ParserError::AbortedSysEx);
+                    derived().sysExStatusChanged(true, sysExValid);
+                    if (sysExValid) return;
+                }
+                else if (statusPending || thirdByteExpected)
+                {
+                    countError(ParserError::InterruptedMessage);
+                }
+                thirdByteExpected = false;
+                if (ip == 0xF0)
+                {
+                    //SysEx cancels running status
+                    runningStatusBuffer = 0;
+                    statusPending = false;
+                    sysExInProgress = true;
+                    derived().sysExStatusChanged(false, true);
+                }
+                else if (ip == 0xF6)
+                {
+                    //Tune Request has no data, and cancels running status
+                    runningStatusBuffer = 0;
+                    statusPending = false;
+                    messageComplete(Message(StatusByte(ip)));
+                }
+                else 
+                {
+                    runningStatusBuffer = ip;
+                    statusPending = true;
+                }
+            }
+
+            void processDataByte(Byte ip)
+            {
+                if (sysExInProgress)
+                {
+                    derived().sysExByteReceived(ip);
+                    return;
+                }
+                Byte status = runningStatusBuffer;
+                if (thirdByteExpected)
+                {
+                    thirdByteExpected = false;
+                    //System Common messages cancel running status
+                    if (status >= 0xF0) runningStatusBuffer = 0;
+                    messageComplete(Message(status, dataByteBuffer, ip));
+                    return;
+                }
+                if (status == 0)
+                {
+                    countError(ParserError::OrphanData);
+                    return;
+                }
+                statusPending = false;
+                if (hasTwoDataBytes(status))
+                {
+                    thirdByteExpected = true;
+                    dataByteBuffer = ip;
+                }
+                else 
+                {
+                    if (status >= 0xF0) runningStatusBuffer = 0;
+                    messageComplete(Message(status, ip));
+                }
+            }
+
+            /**
+             * @brief Check whether a channel or System Common status byte 
+             *        is followed by two data bytes rather than one.
+             */
+            static bool hasTwoDataBytes(Byte status)
+            {
+                return (status < 0xC0) || 
+                       ((status >= 0xE0) && (status < 0xF0)) || 
+                       (status == 0xF2);
+            }
+
+            /**
+             * @brief Drop the message being parsed and running status, so 
+             *        data bytes are ignored until the next status byte.
+             */
+            void resynchronise()
+            {
+                runningStatusBuffer = 0;
+                thirdByteExpected = false;
+                statusPending = false;
+            }
+
+            void countError(ParserError error)
+            {
+                Byte index = static_cast<Byte>(error);
+                errorCounts[index] = errorCounts[index] + 1;
+            }
+    };
+}
+#endif
@@ -0,0 +1,439 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiVoiceAllocator.h 
+//!  @brief Constant time polyphonic voice allocation
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_INPUT_VOICE_ALLOCATOR_H_
+#define _RT_MIDI_INPUT_VOICE_ALLOCATOR_H_
+
+#include "../Core/RTMidiCore.h"
+#include "./RTMidiInputChannelListener.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Interface class for a synthesis engine driven by a 
+     *        VoiceAllocator.
+     */
+    class VoiceListener 
+    {
+        public:
+            /**
+             * @brief Event handler called when a voice should start 
+             *        playing a note.  If the voice was playing another note
+             *        it has been stolen and should restart immediately.
+             * 
+             * @param voice The voice number (0 - VOICES-1)
+             * @param note The note number (0-127)
+             * @param velocity The note on velocity (1-127)
+             */
+            virtual void voiceStarted(Byte voice, Byte note, Byte velocity) = 0;
+
+            /**
+             * @brief Event handler called when a voice's note is released.
+             *        The voice may be given a new note at any time after 
+             *        this, so a release tail is cut short if voices run out.
+             * 
+             * @param voice The voice number (0 - VOICES-1)
+             * @param note The note that was released
+             * @param velocity The note off velocity
+             */
+            virtual void voiceReleased(Byte voice, Byte note, Byte velocity) = 0;
+    };
+
+    /**
+     * @brief The voice a VoiceAllocator takes when every voice is in use.
+     */
+    enum class StealMode: Byte 
+    {
+        Oldest,
+        Quietest,
+        LowestNote,
+        HighestNote
+    };
+
+    /**
+     * @brief Input channel listener that assigns notes to a fixed number 
+     *        of voices.
+     * 
+     *        Note on and note off take constant time: each note maps 
+     *        straight to its voice, free voices are kept in a queue (so the 
+     *        voice released longest ago is reused first), and sounding 
+     *        voices are kept in a list in the order they started.  The 
+     *        voice to steal when none are free is found in constant time 
+     *        for every StealMode.
+     * 
+     *        A note that is already sounding restarts on its own voice when
+     *        retriggering is enabled (the default).  Otherwise it takes a 
+     *        new voice and the old one is released.
+     * 
+     *        While the sustain pedal (CC64) is down, note offs are deferred
+     *        until it is released.  All Notes Off releases every voice 
+     *        as if each note had been released, so notes held by the 
+     *        pedal keep sounding until it is released.  All Sound Off 
+     *        releases every voice at once.
+     * 
+     *        Note events are consumed.  All other events are forwarded to 
+     *        the downstream InputChannelListener.
+     * 
+     * @tparam VOICES The number of voices (1 - 64)
+     */
+    template<unsigned int VOICES>
+    class VoiceAllocator: public InputChannelListener 
+    {
+        static_assert((VOICES > 0) && (VOICES <= 64), 
+                      "A VoiceAllocator supports 1 to 64 voices");
+
+        public:
+            static constexpr Byte NoVoice = 0xFF;
+            static constexpr Byte SustainThreshold = 64;
+            static constexpr Byte VelocityBuckets = 8;
+
+            VoiceAllocator(VoiceListener* voiceListener = nullptr,
+                           InputChannelListener* downstreamListener = nullptr,
+                           StealMode voiceStealMode = StealMode::Oldest):
+                voices(voiceListener),
+                downstream(downstreamListener),
+                stealMode(voiceStealMode),
+                retrigger(true)
+            {
+                reset();
+            }
+
+            void attachVoiceListener(VoiceListener* newListener)
+            {
+                voices = newListener;
+            }
+
+            void attachListener(InputChannelListener* newListener)
+            {
+                downstream = newListener;
+            }
+
+            void setStealMode(StealMode mode){ stealMode = mode; };
+
+            void setRetrigger(bool enable){ retrigger = enable; };
+
+            /**
+             * @brief Free every voice without sending any events.
+             */
+            void reset()
+            {
+                for (unsigned int i = 0; i < 128; i++) noteVoice[i] = NoVoice;
+                for (Byte v = 0; v < VOICES; v++)
+                {
+                    voiceNote[v] = DataByte::Invalid;
+                    voiceVelocity[v] = 0;
+                    freeQueue[v] = v;
+                }
+                for (Byte b = 0; b < VelocityBuckets; b++) velocityVoices[b] = 0;
+                freeHead = 0;
+                freeCount = VOICES;
+                oldest = NoVoice;
+                newest = NoVoice;
+                sounding.clearAll();
+                sustained.clearAll();
+                sustainDown = false;
+            }
+
+            /**
+             * @brief Release every sounding voice.
+             */
+            void releaseAll()
+            {
+                while (oldest != NoVoice) releaseVoice(oldest, 0);
+                sustained.clearAll();
+            }
+
+            /**
+             * @brief Get the voice playing a note, or NoVoice.
+             */
+            Byte voiceForNote(Byte note) const 
+            {
+                return noteVoice[note & DataByte::Max];
+            }
+
+            /**
+             * @brief Get the note a voice is playing, or DataByte::Invalid.
+             */
+            Byte noteForVoice(Byte voice) const 
+            {
+                return (voice < VOICES) ? voiceNote[voice] : DataByte::Invalid;
+            }
+
+            /**
+             * @brief Get the number of voices currently sounding.
+             */
+            Byte activeVoices() const { return VOICES - freeCount; };
+
+            bool isSustained() const { return sustainDown; };
+
+            void noteEventReceived(Byte note, Byte velocity, bool noteOn) override
+            {
+                note &= DataByte::Max;
+                if (noteOn && velocity) startNote(note, velocity);
+                else stopNote(note, velocity);
+            }
+
+            void controlChangeReceived(Byte number, Byte value) override 
+            {
+                switch (static_cast<ControllerNumber>(number))
+                {
+                    case ControllerNumber::SustainPedal:
+                        setSustain(value >= SustainThreshold);
+                        break;
+                    case ControllerNumber::AllSoundOff:
+                        releaseAll();
+                        break;
+                    case ControllerNumber::AllNotesOff:
+                        stopAllNotes();
+                        break;
+                    default:
+                        break;
+                }
+                if (downstream) downstream->controlChangeReceived(number, value);
+            }
+
+            void programChangeReceived(Byte number) override 
+            {
+                if (downstream) downstream->programChangeReceived(number);
+            }
+
+            void aftertouchReceived(Byte pressure, Byte key = DataByte::Invalid) override
+            {
+                if (downstream) downstream->aftertouchReceived(pressure, key);
+            }
+
+            void pitchBendChangeReceived(Byte lsb, Byte msb) override 
+            {
+                if (downstream) downstream->pitchBendChangeReceived(lsb, msb);
+            }
+
+        protected:
+            VoiceListener* voices;
+            InputChannelListener* downstream;
+            StealMode stealMode;
+            bool retrigger;
+            bool sustainDown;
+
+            //The voice playing each note
+            Byte noteVoice[128];
+            //The note and velocity of each voice
+            Byte voiceNote[VOICES];
+            Byte voiceVelocity[VOICES];
+            //Sounding voices as a list from oldest to newest
+            Byte olderVoice[VOICES];
+            Byte newerVoice[VOICES];
+            Byte oldest;
+            Byte newest;
+            //Free voices in the order they were released
+            Byte freeQueue[VOICES];
+            Byte freeHead;
+            Byte freeCount;
+            //Sounding voices by velocity, a bit per voice
+            uint64_t velocityVoices[VelocityBuckets];
+            //Notes with a voice, and notes held only by the sustain pedal
+            NoteBitmap sounding;
+            NoteBitmap sustained;
+
+            static Byte bucketOf(Byte velocity)
+            {
+                return (velocity >> 4) & (VelocityBuckets - 1);
+            }
+
+            static uint64_t voiceBit(Byte voice)
+            {
+                return static_cast<uint64_t>(1) << voice;
+            }
+
+            void startNote(Byte note, Byte velocity)
+            {
+                Byte voice = noteVoice[note];
+                sustained.clear(note);
+                if (voice != NoVoice)
+                {
+                    if (retrigger)
+                    {
+                        //Restart on the same voice as the newest voice
+                        unlinkVoice(voice);
+                        assignVoice(voice, note, velocity);
+                        return;
+                    }
+                    releaseVoice(voice, 0);
+                }
+                if (freeCount)
+                {
+                    voice = freeQueue[freeHead];
+                    freeHead = (freeHead + 1) % VOICES;
+                    freeCount--;
+                }
+                else 
+                {
+                    voice = voiceToSteal();
+                    unlinkVoice(voice);
+                    sounding.clear(voiceNote[voice]);
+                    sustained.clear(voiceNote[voice]);
+                    noteVoice[voiceNote[voice]] = NoVoice;
+                }
+                assignVoice(voice, note, velocity);
+            }
+
+            void stopNote(Byte note, Byte velocity)
+            {
+                Byte voice = noteVoice[note];
+                if (voice == NoVoice) return;
+                if (sustainDown) sustained.set(note);
+                else releaseVoice(voice, velocity);
+            }
+
+            void stopAllNotes()
+            {
+                if (!sustainDown) 
+                {
+                    releaseAll();
+                    return;
+                }
+                //Defer every sounding note until the pedal is released
+                for (Byte note = sounding.lowest(); note <= DataByte::Max;
+                     note = sounding.nextFrom(note + 1))
+                {
+                    sustained.set(note);
+                }
+            }
+
+            void setSustain(bool down)
+            {
+                if (down == sustainDown) return;
+                sustainDown = down;
+                if (down) return;
+                Byte note = sustained.lowest();
+                while (note != DataByte::Invalid)
+                {
+                    if (noteVoice[note] != NoVoice) releaseVoice(noteVoice[note], 0);
+                    note = sustained.nextFrom(note + 1);
+                }
+                sustained.clearAll();
+            }
+
+            void assignVoice(Byte voice, Byte note, Byte velocity)
+            {
+                voiceNote[voice] = note;
+                voiceVelocity[voice] = velocity;
+                noteVoice[note] = voice;
+                sounding.set(note);
+                velocityVoices[bucketOf(velocity)] |= voiceBit(voice);
+                //Append as the newest voice
+                olderVoice[voice] = newest;
+                newerVoice[voice] = NoVoice;
+                if (newest != NoVoice) newerVoice[newest] = voice;
+                else oldest = voice;
+                newest = voice;
+                if (voices) voices->voiceStarted(voice, note, velocity);
+            }
+
+            void unlinkVoice(Byte voice)
+            {
+                Byte older = olderVoice[voice];
+                Byte newer = newerVoice[voice];
+                if (older != NoVoice) newerVoice[older] = newer;
+                else oldest = newer;
+                if (newer != NoVoice) olderVoice[newer] = older;
+                else newest = older;
+                velocityVoices[bucketOf(voiceVelocity[voice])] &= ~voiceBit(voice);
+            }
+
+            void releaseVoice(Byte voice, Byte velocity)
+            {
+                Byte note = voiceNote[voice];
+                unlinkVoice(voice);
+                noteVoice[note] = NoVoice;
+                sounding.clear(note);
+                voiceNote[voice] = DataByte::Invalid;
+                freeQueue[(freeHead + freeCount) % VOICES] = voice;
+                freeCount++;
+                if (voices) voices->voiceReleased(voice, note, velocity);
+            }
+
+            Byte voiceToSteal() const 
+            {
+                switch (stealMode)
+                {
+                    case StealMode::Quietest:
+                        for (Byte b = 0; b < VelocityBuckets; b++)
+                        {
+                            if (velocityVoices[b]) 
+                            {
+                                return __builtin_ctzll(velocityVoices[b]);
+                            }
+                        }
+                        return oldest;
+                    case StealMode::LowestNote:
+                        return noteVoice[sounding.lowest()];
+                    case StealMode::HighestNote:
+                        return noteVoice[sounding.highest()];
+                    case StealMode::Oldest:
+                    default:
+                        return oldest;
+                }
+            }
+    };
+
+    template<unsigned int VOICES>
+    constexpr Byte VoiceAllocator<VOICES>::NoVoice;
+}
+#endif
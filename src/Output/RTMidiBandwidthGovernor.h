@@ -0,0 +1,338 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiBandwidthGovernor.h 
+//!  @brief Keeps the traffic sent to a MIDI link within its bandwidth
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_OUTPUT_BANDWIDTH_GOVERNOR_H_
+#define _RT_MIDI_OUTPUT_BANDWIDTH_GOVERNOR_H_
+
+#include "../Core/RTMidiCore.h"
+#include "./RTMidiTransmitter.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Transmitter that budgets the wire time of the messages sent 
+     *        through it to an output.
+     * 
+     *        The governor models the output's queue as a byte time debt: 
+     *        every message sent adds its length times the link's byte 
+     *        time, and the debt drains in real time as the link sends.  
+     *        The debt is therefore the projected queueing delay of the 
+     *        next message.
+     * 
+     *        Low priority traffic (see isLowPriority()) is thinned when the
+     *        debt passes the thinning threshold: instead of being sent, it 
+     *        is held in one of SLOTS coalescing slots, where a newer value 
+     *        for the same controller replaces an older one, and sent by 
+     *        service() once the debt has fallen.  When no slot is free and
+     *        the debt is over the latency budget, it is dropped.  All 
+     *        other traffic is always sent, so notes are never lost.
+     * 
+     *        Coalesced messages may be sent after later, unrelated 
+     *        messages.  Continuous controller values do not depend on that
+     *        order, which is why only they are thinned.
+     * 
+     *        service() must be called regularly (at least once per 
+     *        millisecond is ideal) with the current time in microseconds.
+     * 
+     * @tparam SLOTS The number of coalescing slots
+     */
+    template<unsigned int SLOTS = 8>
+    class BandwidthGovernor: public Transmitter 
+    {
+        public:
+            /**
+             * @brief The time over which utilisation is measured
+             */
+            static constexpr Word UtilisationWindowMicros = 100000;
+
+            /**
+             * @brief Construct a new BandwidthGovernor
+             * 
+             * @param destination The output to send to
+             * @param speed The link speed of the output
+             * @param latencyBudgetMicros The most queueing delay low 
+             *                            priority traffic may add to
+             * @param thinThresholdMicros The queueing delay above which low 
+             *                            priority traffic is coalesced
+             */
+            BandwidthGovernor(Transmitter* destination = nullptr,
+                              LinkSpeed speed = MidiLinkSpeed,
+                              Word latencyBudgetMicros = 10000,
+                              Word thinThresholdMicros = 2000):
+                output(destination),
+                nanosPerByte(speed.nanosPerByte()),
+                budget(latencyBudgetMicros * 1000),
+                thinThreshold(thinThresholdMicros * 1000),
+                debt(0),
+                lastMicros(0),
+                windowStart(0),
+                windowBusy(0),
+                utilisation(0),
+                thinned(0),
+                dropped(0),
+                slotsUsed(0),
+                serviced(false){};
+
+            void attachOutput(Transmitter* destination){ output = destination; };
+
+            void setLinkSpeed(LinkSpeed speed)
+            { 
+                nanosPerByte = speed.nanosPerByte(); 
+            };
+
+            void setLatencyBudget(Word micros){ budget = micros * 1000; };
+
+            void setThinThreshold(Word micros){ thinThreshold = micros * 1000; };
+
+            void sendMessage(Message msg) override
+            {
+                if (isLowPriority(msg))
+                {
+                    Byte slot = findSlot(msg);
+                    if (slot < slotsUsed)
+                    {
+                        //Replace the older value still waiting
+                        slots[slot] = msg;
+                        thinned++;
+                        return;
+                    }
+                    Word cost = costOf(msg);
+                    if (debt + cost > thinThreshold)
+                    {
+                        if (slotsUsed < SLOTS) slots[slotsUsed++] = msg;
+                        else if (debt + cost > budget) 
+                        {
+                            dropped++;
+                            return;
+                        }
+                        else transmit(msg);
+                        return;
+                    }
+                }
+                transmit(msg);
+            }
+
+            /**
+             * @brief Send a message, reporting whether the output accepted 
+             *        it.  Low priority messages are always accepted, as they
+             *        may be coalesced or dropped by design.
+             */
+            bool trySendMessage(Message msg) override
+            {
+                if (isLowPriority(msg))
+                {
+                    sendMessage(msg);
+                    return true;
+                }
+                return transmit(msg);
+            }
+
+            /**
+             * @brief Advance the model to the current time and send any 
+             *        coalesced messages that now fit.
+             * 
+             * @param nowMicros The current time in microseconds
+             */
+            void service(Word nowMicros)
+            {
+                if (!serviced)
+                {
+                    //The clock is free running, so the first call only 
+                    //sets the starting time
+                    serviced = true;
+                    lastMicros = nowMicros;
+                    windowStart = nowMicros;
+                }
+                Word gap = nowMicros - lastMicros;
+                lastMicros = nowMicros;
+                //Compare before scaling to nanoseconds, as a gap of more 
+                //than about 4.29 seconds would overflow
+                Word drained = (gap > debt / 1000) ? debt : gap * 1000;
+                debt -= drained;
+                windowBusy += drained;
+                Word window = nowMicros - windowStart;
+                if (window >= UtilisationWindowMicros)
+                {
+                    utilisation = windowBusy / window;
+                    windowStart = nowMicros;
+                    windowBusy = 0;
+                }
+                while (slotsUsed && 
+                       ((debt + costOf(slots[0])) <= thinThreshold))
+                {
+                    transmit(slots[0]);
+                    slotsUsed--;
+                    for (Byte i = 0; i < slotsUsed; i++) slots[i] = slots[i + 1];
+                }
+            }
+
+            /**
+             * @brief Get the time the next message will wait before it is 
+             *        sent.
+             * 
+             * @return The projected queueing delay in microseconds
+             */
+            Word getQueueingDelay() const { return debt / 1000; };
+
+            /**
+             * @brief Get the fraction of the link's capacity used over the 
+             *        last measurement window.
+             * 
+             * @return The utilisation in parts per thousand
+             */
+            Word getUtilisation() const { return utilisation; };
+
+            /**
+             * @brief Get the number of low priority messages that were 
+             *        replaced by a newer value before being sent.
+             */
+            Word getThinnedCount() const { return thinned; };
+
+            /**
+             * @brief Get the number of low priority messages that were 
+             *        dropped because the latency budget was exceeded.
+             */
+            Word getDroppedCount() const { return dropped; };
+
+            /**
+             * @brief Check if a message may be thinned.
+             * 
+             *        Pitch bend, poly and channel pressure and continuous 
+             *        controllers are low priority.  Bank select, parameter 
+             *        selection and data entry, switch pedals and channel 
+             *        mode messages are not, because their order matters.
+             */
+            static bool isLowPriority(Message msg)
+            {
+                MessageTypeMask type = MessageFilter::typeBit(msg.getStatus());
+                if (type & (TypePolyphonicKeyPressure | 
+                            TypeChannelPressure | 
+                            TypePitchBend)) return true;
+                if (type & TypeControlChange)
+                {
+                    return isContinuousController(msg.getFirstDataByte());
+                }
+                return false;
+            }
+
+        protected:
+            Transmitter* output;
+            Word nanosPerByte;
+            Word budget;
+            Word thinThreshold;
+            Word debt;
+            Word lastMicros;
+            Word windowStart;
+            Word windowBusy;
+            Word utilisation;
+            Word thinned;
+            Word dropped;
+            Message slots[SLOTS];
+            Byte slotsUsed;
+            bool serviced;
+
+            Word costOf(Message msg) const 
+            {
+                return msg.byteLength() * nanosPerByte;
+            }
+
+            bool transmit(Message msg)
+            {
+                if (output && !output->trySendMessage(msg)) return false;
+                debt += costOf(msg);
+                return true;
+            }
+
+            Byte findSlot(Message msg) const 
+            {
+                Byte status = msg.getStatus();
+                bool keyed = (status < 0xD0);
+                for (Byte i = 0; i < slotsUsed; i++)
+                {
+                    if (slots[i].getStatus() != status) continue;
+                    if (!keyed) return i;
+                    if (slots[i].getFirstDataByte() == msg.getFirstDataByte()) return i;
+                }
+                return slotsUsed;
+            }
+
+            static bool isContinuousController(Byte number)
+            {
+                if (number >= 120) return false;
+                switch (static_cast<ControllerNumber>(number))
+                {
+                    case ControllerNumber::BankSelect:
+                    case ControllerNumber::BankSelectLsb:
+                    case ControllerNumber::DataEntryMsb:
+                    case ControllerNumber::DataEntryLsb:
+                        return false;
+                    default:
+                        break;
+                }
+                if ((number >= 64) && (number <= 69)) return false;
+                if ((number >= 96) && (number <= 101)) return false;
+                return true;
+            }
+    };
+
+    template<unsigned int SLOTS>
+    constexpr Word BandwidthGovernor<SLOTS>::UtilisationWindowMicros;
+}
+#endif
@@ -0,0 +1,218 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiHeldNoteTracker.h 
+//!  @brief Tracks the notes held on an output
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_OUTPUT_HELD_NOTE_TRACKER_H_
+#define _RT_MIDI_OUTPUT_HELD_NOTE_TRACKER_H_
+
+#include "../Core/RTMidiCore.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The velocity of note offs sent to release held notes
+     */
+    constexpr Byte ReleaseVelocity = 64;
+
+    /**
+     * @brief Tracks which notes are held on each of the 16 MIDI channels 
+     *        of an output, so that a panic only has to release the notes 
+     *        that are actually sounding.
+     * 
+     *        Notes are tracked as a set, so a note that is started twice 
+     *        is released by its first note off.
+     */
+    class HeldNoteTracker 
+    {
+        public:
+            HeldNoteTracker(): activeChannels(0){};
+
+            /**
+             * @brief Update the held notes with a message being sent.
+             */
+            void update(Message msg)
+            {
+                StatusByte status = msg.getStatus();
+                if (!status.isChannelVoice()) return;
+                Byte ch = status.lowNibble();
+                switch (status.getStatusCode())
+                {
+                    case StatusCode::NoteOn:
+                        if (msg.getSecondDataByte() != 0)
+                        {
+                            notes[ch].set(msg.getFirstDataByte());
+                            activeChannels |= channelBit(ch);
+                            break;
+                        }
+                        release(ch, msg.getFirstDataByte());
+                        break;
+                    case StatusCode::NoteOff:
+                        release(ch, msg.getFirstDataByte());
+                        break;
+                    case StatusCode::ControlChange:
+                        if ((msg.getFirstDataByte() == static_cast<Byte>(ControllerNumber::AllSoundOff)) ||
+                            (msg.getFirstDataByte() == static_cast<Byte>(ControllerNumber::AllNotesOff)))
+                        {
+                            notes[ch].clearAll();
+                            activeChannels &= ~channelBit(ch);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            /**
+             * @brief Get a note off for the next held note and forget that 
+             *        note.
+             * 
+             * @return The note off, or an invalid message if no notes are 
+             *         held.
+             */
+            Message nextRelease()
+            {
+                if (!activeChannels) return Message::invalid();
+                return nextRelease(static_cast<Channel>(__builtin_ctz(activeChannels)));
+            }
+
+            /**
+             * @brief Get a note off for the next held note on one channel 
+             *        and forget that note.
+             * 
+             * @return The note off, or an invalid message if no notes are 
+             *         held on the channel.
+             */
+            Message nextRelease(Channel ch)
+            {
+                Message noteOff = peekRelease(ch);
+                if (noteOff.isValid()) update(noteOff);
+                return noteOff;
+            }
+
+            /**
+             * @brief Get a note off for the next held note on one channel 
+             *        without forgetting the note.  Passing the note off to 
+             *        update() once it has been sent forgets it.
+             * 
+             * @return The note off, or an invalid message if no notes are 
+             *         held on the channel.
+             */
+            Message peekRelease(Channel ch) const 
+            {
+                Byte index = ch & 0x0F;
+                if (!notes[index].any()) return Message::invalid();
+                return Message::createChannelMessage(static_cast<Channel>(index),
+                                                     StatusCode::NoteOff,
+                                                     notes[index].lowest(), 
+                                                     ReleaseVelocity);
+            }
+
+            bool isHeld(Channel ch, Byte note) const 
+            {
+                return notes[ch & 0x0F].test(note);
+            }
+
+            bool any() const { return activeChannels != 0; };
+
+            /**
+             * @brief Get the number of held notes on all channels.
+             */
+            unsigned int count() const 
+            {
+                unsigned int total = 0;
+                for (Byte ch = 0; ch < 16; ch++) total += notes[ch].count();
+                return total;
+            }
+
+            const NoteBitmap& getNotes(Channel ch) const 
+            {
+                return notes[ch & 0x0F];
+            }
+
+            void clear()
+            {
+                for (Byte ch = 0; ch < 16; ch++) notes[ch].clearAll();
+                activeChannels = 0;
+            }
+
+            /**
+             * @brief Forget the held notes of one channel.
+             */
+            void clear(Channel ch)
+            {
+                notes[ch & 0x0F].clearAll();
+                activeChannels &= ~channelBit(ch & 0x0F);
+            }
+        protected:
+            NoteBitmap notes[16];
+            uint16_t activeChannels;
+
+            static uint16_t channelBit(Byte ch)
+            {
+                return static_cast<uint16_t>(1u << ch);
+            }
+
+            void release(Byte ch, Byte note)
+            {
+                notes[ch].clear(note);
+                if (!notes[ch].any()) activeChannels &= ~channelBit(ch);
+            }
+    };
+}
+#endif
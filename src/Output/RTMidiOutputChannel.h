@@ -63,6 +63,7 @@
 
 #include "../Core/RTMidiCore.h"
 #include "./RTMidiTransmitter.h"
+#include "./RTMidiHeldNoteTracker.h"
 
 namespace RTMIDI 
 {
@@ -71,7 +72,9 @@ namespace RTMIDI
         public:
             OutputChannel(Channel ch = ChNone, 
                           Transmitter* attachedTransmitter = nullptr): 
-                transmitter(attachedTransmitter), channel(ch){};
+                transmitter(attachedTransmitter), channel(ch),
+                selectedParameter(), dataEntryMsb(DataByte::Invalid),
+                heldNotes(nullptr){};
 
             void attachTransmitter(Transmitter* newTransmitter)
             {
@@ -97,24 +100,195 @@ namespace RTMIDI
 
             void sendControlChangeMessage(Byte ccNumber, Byte ccValue)
             {
+                trackParameterControllers(ccNumber, ccValue);
                 transmitMessage(Message::createControlChange(channel, 
                                                              ccNumber,
                                                              ccValue));
             };
 
+            /**
+             * @brief Send a 14 bit parameter change.
+             * 
+             *        For RPNs and NRPNs the currently selected parameter and 
+             *        data entry MSB are remembered, so parameter select and 
+             *        data entry MSB controllers are only sent when they 
+             *        change.  A run of changes to one parameter whose MSB 
+             *        does not change is sent as data entry LSB (38) alone.
+             * 
+             *        14 bit controllers are sent as the MSB controller 
+             *        followed by the LSB controller (number + 32).
+             * 
+             * @param parameter The parameter to change
+             * @param value The 14 bit value
+             * @param sendLsb If false, only the 7 most significant bits of 
+             *                the value are sent.
+             */
+            void sendParameterChange(ParameterNumber parameter, Word value,
+                                     bool sendLsb = true)
+            {
+                Byte msb = (value >> 7) & DataByte::Max;
+                Byte lsb = value & DataByte::Max;
+                if (parameter.getType() == ParameterType::HighResolutionController)
+                {
+                    Byte number = parameter.getNumber() & 0x1F;
+                    transmitController(number, msb);
+                    if (sendLsb) transmitController(number + 32, lsb);
+                    return;
+                }
+                if (parameter.isNull()) return;
+                selectParameter(parameter);
+                if (!sendLsb || (msb != dataEntryMsb))
+                {
+                    transmitController(ControllerNumber::DataEntryMsb, msb);
+                    dataEntryMsb = msb;
+                }
+                if (sendLsb) transmitController(ControllerNumber::DataEntryLsb, lsb);
+            }
+
+            /**
+             * @brief Send the RPN null parameter, deselecting the current 
+             *        parameter at the receiver.
+             */
+            void sendNullParameter()
+            {
+                selectParameter(ParameterNumber::registered(ParameterNumber::Null));
+            }
+
+            /**
+             * @brief Forget the remembered parameter selection so that the 
+             *        next parameter change is sent in full.  Call this if 
+             *        the receiver may have lost its state.
+             */
+            void resetParameterSelection()
+            {
+                selectedParameter = ParameterNumber();
+                dataEntryMsb = DataByte::Invalid;
+            }
+
+            /**
+             * @brief Keep track of the notes held on this channel, so that 
+             *        releaseAll() can release them.
+             * 
+             *        The tracker may be shared with other channels of the 
+             *        same output.  This channel only sets and releases 
+             *        notes on its own MIDI Channel.
+             * 
+             * @param tracker The tracker to use, or nullptr to stop tracking.
+             */
+            void trackHeldNotes(HeldNoteTracker* tracker)
+            {
+                heldNotes = tracker;
+                if (heldNotes && (channel <= Ch15)) heldNotes->clear(channel);
+            }
+
+            /**
+             * @brief Send a note off for every note held on this channel.  
+             *        Only works while held notes are being tracked.  A note
+             *        is only forgotten once the transmitter has accepted 
+             *        its note off.
+             * 
+             * @return The number of held notes whose note off was not 
+             *         accepted.  Call again once the output has drained.
+             */
+            unsigned int releaseAll()
+            {
+                if (!heldNotes || (channel > Ch15)) return 0;
+                Message noteOff = heldNotes->peekRelease(channel);
+                while (noteOff.isValid())
+                {
+                    if (!transmitMessage(noteOff))
+                    {
+                        return heldNotes->getNotes(channel).count();
+                    }
+                    noteOff = heldNotes->peekRelease(channel);
+                }
+                return 0;
+            }
+
             void sendMessage(Message msg) override
             {
-                if (!msg.getStatus().isChannelVoice()) return;
+                trySendMessage(msg);
+            }
+
+            bool trySendMessage(Message msg) override
+            {
+                if (!msg.getStatus().isChannelVoice()) return false;
+                if (msg.getStatus().getStatusCode() == StatusCode::ControlChange)
+                {
+                    trackParameterControllers(msg.getFirstDataByte(), 
+                                              msg.getSecondDataByte());
+                }
                 msg.setChannel(channel);
-                transmitMessage(msg);
+                return transmitMessage(msg);
             }
 
         protected:
             Transmitter* transmitter;
             Channel channel;
-            void transmitMessage(Message msg)
+            ParameterNumber selectedParameter;
+            Byte dataEntryMsb;
+            HeldNoteTracker* heldNotes;
+
+            /**
+             * @brief Send a message, updating the held notes only once the 
+             *        transmitter has accepted it.
+             */
+            bool transmitMessage(Message msg)
+            {
+                if (transmitter && !transmitter->trySendMessage(msg)) return false;
+                if (heldNotes) heldNotes->update(msg);
+                return true;
+            }
+
+            void transmitController(Byte number, Byte value)
+            {
+                transmitMessage(Message::createControlChange(channel, 
+                                                             number, value));
+            }
+
+            void transmitController(ControllerNumber number, Byte value)
+            {
+                transmitController(static_cast<Byte>(number), value);
+            }
+
+            void selectParameter(ParameterNumber parameter)
             {
-                if (transmitter) transmitter->sendMessage(msg);
+                if (parameter == selectedParameter) return;
+                bool registered = (parameter.getType() == ParameterType::Registered);
+                if ((parameter.getType() != selectedParameter.getType()) ||
+                    (parameter.msb() != selectedParameter.msb()))
+                {
+                    transmitController(registered ? ControllerNumber::RPNMsb :
+                                                    ControllerNumber::NRPNMsb,
+                                       parameter.msb());
+                }
+                transmitController(registered ? ControllerNumber::RPNLsb :
+                                                ControllerNumber::NRPNLsb,
+                                   parameter.lsb());
+                selectedParameter = parameter;
+                dataEntryMsb = DataByte::Invalid;
+            }
+
+            /**
+             * @brief Keep the remembered parameter state valid when parameter
+             *        controllers are sent directly.
+             */
+            void trackParameterControllers(Byte number, Byte value)
+            {
+                switch(static_cast<ControllerNumber>(number))
+                {
+                    case ControllerNumber::NRPNMsb:
+                    case ControllerNumber::NRPNLsb:
+                    case ControllerNumber::RPNMsb:
+                    case ControllerNumber::RPNLsb:
+                        resetParameterSelection();
+                        break;
+                    case ControllerNumber::DataEntryMsb:
+                        dataEntryMsb = value;
+                        break;
+                    default:
+                        break;
+                }
             }
     };
 
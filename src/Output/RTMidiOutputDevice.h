@@ -64,6 +64,7 @@
 #include "../Core/RTMidiCore.h"
 #include "./RTMidiTxHandler.h"
 #include "./RTMidiOutputChannel.h"
+#include "./RTMidiStaticOutputDevice.h"
 
 namespace RTMIDI 
 {
@@ -78,26 +79,53 @@ namespace RTMIDI
             {
                 chs.attachTransmitter(this);
             };
+
+            /**
+             * @brief Take a consistent snapshot of the device's counters.  
+             *        Every counter is zero unless RTMIDI_ENABLE_TELEMETRY is 
+             *        1.
+             */
+            virtual DeviceTelemetry getTelemetry() const 
+            {
+                DeviceTelemetry telemetry;
+                telemetry.clear();
+                readTelemetry(telemetry);
+                return telemetry;
+            }
         protected:
+            /**
+             * @brief Add this device's counters to a snapshot.
+             */
+            virtual void readTelemetry(DeviceTelemetry& telemetry) const 
+            {
+                readTxTelemetry(telemetry);
+            }
     };
 
     template<unsigned int BUFFER_LENGTH, typename BUFFER_INDEX = uint8_t>
-    class OutputDevice: public GenericOutputDevice
+    class OutputDevice: public GenericOutputDevice, 
+                        public OutputQueue<BUFFER_LENGTH, BUFFER_INDEX>
     {
         public:
             void sendMessage(Message msg) override 
             {
-                transmitBuffer.push(msg);
+                this->queueMessage(msg);
+            }
+
+            bool trySendMessage(Message msg) override 
+            {
+                return this->queueMessage(msg);
             }
         protected:
-            MessageBuffer<BUFFER_LENGTH, BUFFER_INDEX> transmitBuffer;
             Message getNextMessage() override 
             {
-                if (transmitBuffer.available())
-                {
-                    return transmitBuffer.pop();
-                }
-                else return Message::invalid();
+                return this->takeMessage();
+            }
+
+            void readTelemetry(DeviceTelemetry& telemetry) const override 
+            {
+                GenericOutputDevice::readTelemetry(telemetry);
+                this->transmitBuffer.readTelemetry(telemetry);
             }
     };
 }
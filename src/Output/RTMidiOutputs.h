@@ -63,7 +63,10 @@
 
 #include "../Core/RTMidiCore.h"
 #include "./RTMidiTransmitter.h"
+#include "./RTMidiHeldNoteTracker.h"
 #include "./RTMidiTxHandler.h"
 #include "./RTMidiOutputDevice.h"
+#include "./RTMidiStaticOutputDevice.h"
+#include "./RTMidiBandwidthGovernor.h"
 
 #endif
\ No newline at end of file
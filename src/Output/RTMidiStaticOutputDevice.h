@@ -0,0 +1,171 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiStaticOutputDevice.h 
+//!  @brief RTMIDI StaticOutputDevice template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_OUTPUT_STATIC_OUTPUT_DEVICE_H_
+#define _RT_MIDI_OUTPUT_STATIC_OUTPUT_DEVICE_H_
+
+#include "../Core/RTMidiCore.h"
+#include "./RTMidiStaticTxHandler.h"
+#include "./RTMidiHeldNoteTracker.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The transmit buffer of an output device, with optional held 
+     *        note tracking.
+     * 
+     *        This is shared by StaticOutputDevice, OutputDevice and 
+     *        ThruDevice, so that held notes are tracked the same way on 
+     *        every output.  The tracker is only updated for messages that 
+     *        fit in the buffer.
+     * 
+     * @tparam BUFFER_LENGTH The length of the transmit buffer
+     * @tparam BUFFER_INDEX The transmit buffer index type
+     */
+    template<unsigned int BUFFER_LENGTH, typename BUFFER_INDEX = uint8_t>
+    class OutputQueue 
+    {
+        public:
+            OutputQueue(): heldNotes(nullptr){};
+
+            /**
+             * @brief Keep track of the notes held on this device as messages
+             *        are queued, so that releaseAll() can release them.
+             * 
+             * @param tracker The tracker to use, or nullptr to stop tracking.
+             */
+            void trackHeldNotes(HeldNoteTracker* tracker)
+            {
+                heldNotes = tracker;
+                if (heldNotes) heldNotes->clear();
+            }
+
+            /**
+             * @brief Queue a note off for every held note.  Only works 
+             *        while held notes are being tracked.
+             * 
+             * @return The number of held notes that did not fit in the 
+             *         transmit buffer.  Call again once it has drained.
+             */
+            unsigned int releaseAll()
+            {
+                if (!heldNotes) return 0;
+                while (heldNotes->any())
+                {
+                    if (transmitBuffer.isFull()) return heldNotes->count();
+                    transmitBuffer.push(heldNotes->nextRelease());
+                }
+                return 0;
+            }
+        protected:
+            MessageBuffer<BUFFER_LENGTH, BUFFER_INDEX> transmitBuffer;
+            HeldNoteTracker* heldNotes;
+
+            bool queueMessage(Message msg)
+            {
+                if (!transmitBuffer.push(msg)) return false;
+                if (heldNotes) heldNotes->update(msg);
+                return true;
+            }
+
+            Message takeMessage()
+            {
+                if (transmitBuffer.available())
+                {
+                    return transmitBuffer.popTimed(LatencyStage::TransmitQueue);
+                }
+                else return Message::invalid();
+            }
+    };
+
+    /**
+     * @brief Output device with a statically dispatched transmit path.
+     * 
+     *        This is the compile time counterpart of OutputDevice.  The 
+     *        DERIVED class only has to provide restartTransmission().
+     * 
+     * @tparam DERIVED The class inheriting from StaticOutputDevice
+     * @tparam BUFFER_LENGTH The length of the transmit buffer
+     * @tparam BUFFER_INDEX The transmit buffer index type
+     */
+    template<class DERIVED, 
+             unsigned int BUFFER_LENGTH, 
+             typename BUFFER_INDEX = uint8_t>
+    class StaticOutputDevice: public StaticTxHandler<DERIVED>, 
+                              public OutputQueue<BUFFER_LENGTH, BUFFER_INDEX>
+    {
+        public:
+            void sendMessage(Message msg)
+            {
+                this->queueMessage(msg);
+            }
+
+            bool trySendMessage(Message msg)
+            {
+                return this->queueMessage(msg);
+            }
+
+            Message getNextMessage()
+            {
+                return this->takeMessage();
+            }
+    };
+}
+#endif
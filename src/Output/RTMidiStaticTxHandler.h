@@ -0,0 +1,298 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiStaticTxHandler.h 
+//!  @brief RTMIDI StaticTxHandler template class definition
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_OUTPUT_STATIC_TX_HANDLER_H_
+#define _RT_MIDI_OUTPUT_STATIC_TX_HANDLER_H_
+
+#include "../Core/RTMidiCore.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Statically dispatched MIDI byte stream transmitter.
+     * 
+     *        StaticTxHandler serializes messages supplied by the DERIVED 
+     *        class into a byte stream, one byte per call to getNextByte().
+     *        The DERIVED class is reached through the curiously recurring 
+     *        template pattern so that the message source can be inlined 
+     *        into the transmit interrupt.
+     * 
+     *        The DERIVED class must provide the following member functions
+     *        (either public or with StaticTxHandler<DERIVED> as a friend):
+     * 
+     *          Message getNextMessage();
+     *          void restartTransmission();
+     * 
+     *        getNextMessage() returns Message::invalid() when there is 
+     *        nothing to send.  restartTransmission() is called when new 
+     *        data becomes available while the transmitter is idle.
+     * 
+     *        RTMIDI::TxHandler is this class instantiated with virtual 
+     *        handlers, for use when runtime polymorphism is required.
+     * 
+     * @tparam DERIVED The class inheriting from StaticTxHandler
+     */
+    template<class DERIVED>
+    class StaticTxHandler
+    {
+        public:
+            static constexpr Byte MessageBufferEmpty = 254u;
+
+            StaticTxHandler(): nextMessage(), 
+                               messageOutIndex(MessageBufferEmpty),
+                               realTimeByte(0),
+                               bulkData(nullptr),
+                               bulkInFlash(false),
+                               bulkRemaining(0)
+                            #if RTMIDI_ENABLE_FLIGHT_RECORDER
+                               , flightRecorder(nullptr)
+                            #endif
+                               {};
+
+            /**
+             * @brief Get the next byte that should be transmitted.
+             * 
+             *        This function will normally be called from the 
+             *        transmit interrupt.  Pending realtime bytes take 
+             *        precedence over message bytes.
+             * 
+             * @return The next byte (0-255) or -1 if there is nothing 
+             *         to transmit.
+             */
+            int getNextByte()
+            {
+                int nextByte = takeNextByte();
+            #if RTMIDI_ENABLE_TELEMETRY
+                if (nextByte >= 0) txTelemetry.countByte(nextByte);
+            #endif
+            #if RTMIDI_ENABLE_FLIGHT_RECORDER
+                if ((nextByte >= 0) && flightRecorder) 
+                {
+                    flightRecorder->recordTransmitted(nextByte);
+                }
+            #endif
+                return nextByte;
+            }
+
+            /**
+             * @brief Queue a realtime byte to be sent ahead of any 
+             *        pending message bytes.
+             * 
+             * @param value The realtime status byte
+             */
+            void setRealtimeByte(Byte value)
+            {
+                realTimeByte = value;
+                if (messageOutIndex == MessageBufferEmpty) 
+                {
+                    derived().restartTransmission();
+                }
+            }
+
+            /**
+             * @brief Send a block of bytes straight from where they are 
+             *        stored, without copying them into the message queue.
+             * 
+             *        The block is sent whole between two queued messages, 
+             *        with realtime bytes still sent ahead of it.  It must 
+             *        start with a status byte, and the data must stay valid
+             *        until isSendingBytes() returns false.  Use 
+             *        sendFlashBytes() for data marked RTMIDI_PROGMEM, such 
+             *        as a MessageSequence image.
+             * 
+             * @param data The bytes
+             * @param length The number of bytes
+             * @return False if a block is already being sent
+             */
+            bool sendBytes(const Byte* data, unsigned int length)
+            {
+                return startBulk(data, length, false);
+            }
+
+            /**
+             * @brief Send a block of bytes stored in flash with 
+             *        RTMIDI_PROGMEM, as sendBytes() does for RAM.  On AVR 
+             *        they are read with pgm_read_byte().
+             */
+            bool sendFlashBytes(const Byte* data, unsigned int length)
+            {
+                return startBulk(data, length, true);
+            }
+
+            bool isSendingBytes() const { return bulkRemaining.load() != 0; };
+
+            /**
+             * @brief Add the transmitter's counters to a snapshot.  Nothing 
+             *        is added unless RTMIDI_ENABLE_TELEMETRY is 1.
+             */
+            void readTxTelemetry(DeviceTelemetry& snapshot) const 
+            {
+            #if RTMIDI_ENABLE_TELEMETRY
+                txTelemetry.readInto(snapshot);
+            #endif
+            }
+
+            /**
+             * @brief Record every transmitted byte.  Nothing is recorded 
+             *        unless RTMIDI_ENABLE_FLIGHT_RECORDER is 1.
+             * 
+             * @param recorder The recorder, or nullptr to stop recording
+             */
+            void attachFlightRecorder(FlightRecorder* recorder)
+            {
+            #if RTMIDI_ENABLE_FLIGHT_RECORDER
+                flightRecorder = recorder;
+            #else
+                (void)recorder;
+            #endif
+            }
+
+        protected:
+            Message nextMessage;
+            volatile Byte messageOutIndex;
+            volatile Byte realTimeByte;
+            //The block passed to sendBytes(), published by bulkRemaining
+            const Byte* bulkData;
+            bool bulkInFlash;
+            Atomic<unsigned int> bulkRemaining;
+        #if RTMIDI_ENABLE_TELEMETRY
+            TxTelemetry txTelemetry;
+        #endif
+        #if RTMIDI_ENABLE_FLIGHT_RECORDER
+            FlightRecorder* volatile flightRecorder;
+        #endif
+
+            DERIVED& derived()
+            {
+                return *static_cast<DERIVED*>(this);
+            }
+
+            int takeNextByte()
+            {
+                if (realTimeByte)
+                {
+                    Byte nextByte = realTimeByte;
+                    realTimeByte = 0;
+                    return nextByte;
+                }
+                int nextByte = getNextMessageByte();
+                if (nextByte >= 0) return nextByte;
+                //bulkData is only written while bulkRemaining is 0
+                unsigned int remaining = bulkRemaining.load();
+                if (remaining)
+                {
+                    nextByte = bulkInFlash ? RTMIDI_READ_FLASH_BYTE(bulkData) : 
+                                             *bulkData;
+                    bulkData = bulkData + 1;
+                    bulkRemaining.store(remaining - 1);
+                    //Not MessageBufferEmpty, so that new messages and 
+                    //realtime bytes do not restart transmission
+                    messageOutIndex = 3;
+                    return nextByte;
+                }
+                if (!loadNextMessage()) return -1;
+                return getNextMessageByte();
+            }
+
+            bool startBulk(const Byte* data, unsigned int length, bool inFlash)
+            {
+                if (bulkRemaining.load() != 0) return false;
+                if (length == 0) return true;
+                bulkData = data;
+                bulkInFlash = inFlash;
+                bulkRemaining.store(length);
+                if (messageOutIndex == MessageBufferEmpty) 
+                {
+                    derived().restartTransmission();
+                }
+                return true;
+            }
+
+            bool loadNextMessage()
+            {
+                Message msg = derived().getNextMessage();
+                nextMessage = msg;
+                if (!msg.isValid()) 
+                {
+                    messageOutIndex = MessageBufferEmpty;
+                    return false;
+                }
+                messageOutIndex = 0;
+                return true;
+            }
+
+            int getNextMessageByte()
+            {
+                //Only the status and two data bytes are ever transmitted,
+                //the fourth (reserved) byte of the message is not.
+                while(messageOutIndex < 3)
+                {
+                    Byte nextByte = nextMessage.getByte(messageOutIndex);
+                    messageOutIndex = messageOutIndex + 1;
+                    if (nextByte != DataByte::Invalid) return nextByte;
+                }
+                return -1;
+            }
+    };
+
+    template<class DERIVED>
+    constexpr Byte StaticTxHandler<DERIVED>::MessageBufferEmpty;
+}
+#endif
@@ -69,6 +69,18 @@ namespace RTMIDI
     {
         public:
             virtual void sendMessage(Message msg) = 0;
+
+            /**
+             * @brief Send a message and report whether it was accepted.
+             *        Transmitters that queue messages return false when 
+             *        their queue is full.  Those that cannot tell always 
+             *        return true.
+             */
+            virtual bool trySendMessage(Message msg)
+            {
+                sendMessage(msg);
+                return true;
+            }
     };
 }
 
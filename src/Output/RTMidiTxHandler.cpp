@@ -62,52 +62,11 @@
 
 using namespace RTMIDI;
 
-int TxHandler::getNextByte()
-{
-    if (realTimeByte) return realTimeByte;
-    else if (messageOutIndex < 4)
-    {
-        Byte nextByte = nextMessage.getBytes()[messageOutIndex];
-        if (nextByte != DataByte::Invalid) return nextByte;
-        else return -1;
-    }
-    else if (messageOutIndex == MessageBufferEmpty)
-    {
-        return -1;
-    }
-    else 
-    {
-        bool loaded = loadNextMessage();
-        if (!loaded) return -1;
-        else return getNextMessageByte();
-    }
-}
-
-bool TxHandler::loadNextMessage()
-{
-    Message msg = this->getNextMessage();
-    nextMessage = msg;
-    if (msg.getStatus() == DataByte::Invalid) return false;
-    else
-    {
-        messageOutIndex = 0;
-        return true;
-    }
-}
+//The byte pump itself lives in StaticTxHandler, instantiate the virtual 
+//dispatch version here so it is only compiled once.
+template class RTMIDI::StaticTxHandler<TxHandler>;
 
-int TxHandler::getNextMessageByte()
-{
-    while(messageOutIndex < 4)
-    {
-        Byte nextByte = nextMessage.getByte(messageOutIndex);
-        if (nextByte != DataByte::Invalid) return (int)nextByte;
-        messageOutIndex++;
-    }
-    return -1;
-}
-
-void TxHandler::setRealtimeByte(Byte newValue)
+int TxHandler::getNextByte()
 {
-    realTimeByte = newValue;
-    if (messageOutIndex == MessageBufferEmpty) this->restartTransmission();
+    return StaticTxHandler<TxHandler>::getNextByte();
 }
\ No newline at end of file
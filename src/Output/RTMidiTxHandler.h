@@ -63,23 +63,28 @@
 
 #include "../Core/RTMidiCore.h"
 #include "./RTMidiTransmitter.h"
+#include "./RTMidiStaticTxHandler.h"
 
 namespace RTMIDI 
 {
-    class TxHandler: public Transmitter
+    class TxHandler;
+
+    //Instantiated once in RTMidiTxHandler.cpp
+    extern template class StaticTxHandler<TxHandler>;
+
+    /**
+     * @brief MIDI byte stream transmitter with virtual message source.
+     * 
+     *        This is the runtime polymorphic version of StaticTxHandler.
+     */
+    class TxHandler: public Transmitter, public StaticTxHandler<TxHandler>
     {
+        friend class StaticTxHandler<TxHandler>;
         public:
-            static constexpr Byte MessageBufferEmpty = 254u;
             virtual int getNextByte();
-            void setRealtimeByte(Byte value);
         protected:
-            Message nextMessage;
-            volatile Byte messageOutIndex;
-            volatile Byte realTimeByte;
             virtual Message getNextMessage() = 0;
             virtual void restartTransmission() = 0;
-            bool loadNextMessage(); 
-            int getNextMessageByte();
     };
 
 }
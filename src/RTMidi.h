@@ -65,5 +65,8 @@
 #include "./Input/RTMidiInputs.h"
 #include "./Output/RTMidiOutputs.h"
 #include "./Thru/RTMidiThruDevice.h"
+#include "./Thru/RTMidiRouter.h"
+#include "./Thru/RTMidiMerger.h"
+#include "./USB/RTMidiUSB.h"
 
 #endif
\ No newline at end of file
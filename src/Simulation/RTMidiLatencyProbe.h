@@ -0,0 +1,365 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiLatencyProbe.h 
+//!  @brief Timed message injection and end to end latency measurement
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_SIMULATION_LATENCY_PROBE_H_
+#define _RT_MIDI_SIMULATION_LATENCY_PROBE_H_
+
+#include "../Core/RTMidiCore.h"
+#include "../Input/RTMidiRXHandler.h"
+#include "../Output/RTMidiTxHandler.h"
+#include "./RTMidiSimulator.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The timing of one message through a simulated device graph.
+     */
+    struct LatencySample 
+    {
+        Message msg;
+        //When the message was offered to the first link
+        uint64_t injectedNanos;
+        //When the first link started transmitting it
+        uint64_t sentNanos;
+        //When its last byte reached the probe
+        uint64_t deliveredNanos;
+
+        /**
+         * @brief Get the input to output latency.
+         */
+        uint64_t latencyNanos() const { return deliveredNanos - injectedNanos; };
+
+        /**
+         * @brief Get the time spent waiting for the first link to be free.
+         */
+        uint64_t queueingNanos() const { return sentNanos - injectedNanos; };
+    };
+
+    /**
+     * @brief Interface class for receiving every LatencySample.
+     */
+    class LatencyListener 
+    {
+        public:
+            virtual ~LatencyListener(){};
+            virtual void latencySampled(const LatencySample& sample) = 0;
+    };
+
+    /**
+     * @brief Summary of the samples recorded by a LatencyProbe.
+     */
+    struct LatencyReport 
+    {
+        uint64_t samples;
+        uint64_t minLatencyNanos;
+        uint64_t maxLatencyNanos;
+        uint64_t totalLatencyNanos;
+        uint64_t maxQueueingNanos;
+        uint64_t totalQueueingNanos;
+        //Messages received that matched no injected message
+        uint64_t unmatched;
+
+        void reset()
+        {
+            samples = 0;
+            minLatencyNanos = UINT64_MAX;
+            maxLatencyNanos = 0;
+            totalLatencyNanos = 0;
+            maxQueueingNanos = 0;
+            totalQueueingNanos = 0;
+            unmatched = 0;
+        }
+
+        void add(const LatencySample& sample)
+        {
+            uint64_t latency = sample.latencyNanos();
+            uint64_t queueing = sample.queueingNanos();
+            samples++;
+            if (latency < minLatencyNanos) minLatencyNanos = latency;
+            if (latency > maxLatencyNanos) maxLatencyNanos = latency;
+            totalLatencyNanos += latency;
+            if (queueing > maxQueueingNanos) maxQueueingNanos = queueing;
+            totalQueueingNanos += queueing;
+        }
+
+        uint64_t averageLatencyNanos() const 
+        {
+            return samples ? (totalLatencyNanos / samples) : 0;
+        }
+
+        uint64_t averageQueueingNanos() const 
+        {
+            return samples ? (totalQueueingNanos / samples) : 0;
+        }
+    };
+
+    /**
+     * @brief Transmitter that offers messages at given virtual times and 
+     *        remembers them until a LatencyProbe sees them come out of the 
+     *        device graph.
+     * 
+     *        Connect it to the first link with a VirtualUart.  Messages 
+     *        must be injected in time order.  Messages that never reach 
+     *        the probe (filtered or dropped) are forgotten, and counted as 
+     *        lost, when their slot is needed again.
+     * 
+     * @tparam LENGTH The most messages waiting to be sent or matched
+     */
+    template<unsigned int LENGTH = 256>
+    class MessageInjector: public TxHandler, public SimulationProcess 
+    {
+        public:
+            MessageInjector(Simulator& simulator): 
+                sim(simulator), 
+                oldest(0), 
+                nextToSend(0), 
+                nextDue(0), 
+                nextFree(0), 
+                lost(0){};
+
+            /**
+             * @brief Offer a message at a virtual time.
+             * 
+             * @return False if atNanos is earlier than the previously 
+             *         injected message, or every slot is waiting to be sent
+             */
+            bool inject(Message msg, uint64_t atNanos)
+            {
+                if (atNanos < sim.now()) atNanos = sim.now();
+                if ((nextFree != nextDue) && 
+                    (atNanos < slot(nextFree - 1).injectedNanos)) return false;
+                if ((nextFree - oldest) == LENGTH)
+                {
+                    //Give up on the oldest sent message to make room
+                    if (oldest == nextToSend) return false;
+                    if (!slot(oldest).matched) lost++;
+                    oldest++;
+                    skipMatched();
+                }
+                Record& record = slot(nextFree++);
+                record.msg = msg;
+                record.injectedNanos = atNanos;
+                record.sentNanos = 0;
+                record.matched = false;
+                if (!isScheduled()) sim.schedule(*this, atNanos);
+                return true;
+            }
+
+            /**
+             * @brief Offer a message now.
+             */
+            void sendMessage(Message msg) override 
+            {
+                inject(msg, sim.now());
+            }
+
+            /**
+             * @brief Match a received message with the oldest sent message 
+             *        with the same content.
+             * 
+             * @return False if there is no match
+             */
+            bool match(Message msg, LatencySample& sample)
+            {
+                for (unsigned long i = oldest; i != nextToSend; i++)
+                {
+                    Record& record = slot(i);
+                    if (record.matched || !sameMessage(record.msg, msg)) continue;
+                    record.matched = true;
+                    sample.msg = record.msg;
+                    sample.injectedNanos = record.injectedNanos;
+                    sample.sentNanos = record.sentNanos;
+                    sample.deliveredNanos = sim.now();
+                    skipMatched();
+                    return true;
+                }
+                return false;
+            }
+
+            /**
+             * @brief Get the number of messages forgotten without a match.
+             */
+            uint64_t getLostCount() const { return lost; };
+
+            /**
+             * @brief Check whether every injected message has been sent.
+             */
+            bool isDrained() const { return nextToSend == nextFree; };
+
+            void run(Simulator& simulator) override 
+            {
+                while ((nextDue != nextFree) && 
+                       (slot(nextDue).injectedNanos <= simulator.now()))
+                {
+                    nextDue++;
+                }
+                if (nextDue != nextFree) 
+                {
+                    simulator.schedule(*this, slot(nextDue).injectedNanos);
+                }
+            }
+        protected:
+            struct Record 
+            {
+                Message msg;
+                uint64_t injectedNanos;
+                uint64_t sentNanos;
+                bool matched;
+            };
+
+            Simulator& sim;
+            Record records[LENGTH];
+            //Free running counters into records: 
+            //oldest <= nextToSend <= nextDue <= nextFree
+            unsigned long oldest;
+            unsigned long nextToSend;
+            unsigned long nextDue;
+            unsigned long nextFree;
+            uint64_t lost;
+
+            Record& slot(unsigned long index){ return records[index % LENGTH]; };
+
+            const Record& slot(unsigned long index) const 
+            { 
+                return records[index % LENGTH]; 
+            };
+
+            void skipMatched()
+            {
+                while ((oldest != nextToSend) && slot(oldest).matched) oldest++;
+            }
+
+            static bool sameMessage(Message a, Message b)
+            {
+                return (a.getByte(0) == b.getByte(0)) && 
+                       (a.getByte(1) == b.getByte(1)) && 
+                       (a.getByte(2) == b.getByte(2));
+            }
+
+            Message getNextMessage() override 
+            {
+                if (nextToSend == nextDue) return Message::invalid();
+                Record& record = slot(nextToSend++);
+                record.sentNanos = sim.now();
+                return record.msg;
+            }
+
+            void restartTransmission() override {};
+    };
+
+    /**
+     * @brief Receiver at the end of a simulated device graph that matches 
+     *        every message it receives with its injection, and records 
+     *        the latency.
+     * 
+     * @tparam INJECTOR The MessageInjector the messages came from
+     */
+    template<class INJECTOR>
+    class LatencyProbe: public RxHandler 
+    {
+        public:
+            LatencyProbe(INJECTOR& messageInjector, 
+                         LatencyListener* latencyListener = nullptr):
+                injector(messageInjector), listener(latencyListener)
+            {
+                report.reset();
+            }
+
+            void setListener(LatencyListener* latencyListener)
+            {
+                listener = latencyListener;
+            }
+
+            const LatencyReport& getReport() const { return report; };
+
+            void resetReport(){ report.reset(); };
+        protected:
+            INJECTOR& injector;
+            LatencyListener* listener;
+            LatencyReport report;
+
+            void record(Message msg)
+            {
+                LatencySample sample;
+                if (!injector.match(msg, sample))
+                {
+                    report.unmatched++;
+                    return;
+                }
+                report.add(sample);
+                if (listener) listener->latencySampled(sample);
+            }
+
+            void standardMessageReceived(Message msg) override 
+            {
+                record(msg);
+            }
+
+            void realtimeMessageReceived(Message msg, Word timestamp) override 
+            {
+                record(msg);
+            }
+
+            void sysExStatusChanged(bool terminated, bool startedOrValid) override {};
+            void sysExByteReceived(Byte byte) override {};
+    };
+}
+
+#endif
@@ -0,0 +1,374 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiLoadGenerator.cpp 
+//!  @brief Reproducible synthetic MIDI traffic for benchmarks and simulations
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiLoadGenerator.h"
+
+using namespace RTMIDI;
+
+constexpr unsigned int LoadGenerator::MpeChannels;
+constexpr unsigned int LoadGenerator::ChordSize;
+
+//Non-commercial SysEx ID
+static constexpr Byte LoadSysExId = 0x7D;
+
+LoadGenerator::LoadGenerator(const LoadOptions& options): options(options)
+{
+    reset();
+}
+
+void LoadGenerator::reset()
+{
+    random.reseed(options.seed);
+    statistics = LoadStatistics();
+    timeNanos = 0;
+    uint32_t tempo = options.tempoBpm ? options.tempoBpm : 120;
+    pulseNanos = 60000000000ull / (static_cast<uint64_t>(tempo) * 24);
+    nextPulseNanos = 0;
+    trafficProfiles = options.profiles & ~LoadProfile::Clock;
+
+    pendingLength = 0;
+    pendingIndex = 0;
+    sysExRemaining = 0;
+    sysExEndPending = false;
+    lastStatus = 0;
+    heldByte = -1;
+
+    sweepChannel = 0;
+    sweepController = 1;
+    sweepValue = 0;
+    sweepRising = true;
+    sweepLsbPending = false;
+
+    chordChannel = 0;
+    chordIndex = 0;
+    chordOn = false;
+
+    for (unsigned int i = 0; i < MpeChannels; i++) mpeNotes[i] = 0;
+}
+
+uint64_t LoadGenerator::nextByteNanos() const 
+{
+    bool busy = trafficProfiles || (pendingIndex < pendingLength) || 
+                sysExRemaining || sysExEndPending || (heldByte >= 0);
+    if (busy || (nextPulseNanos < timeNanos)) return timeNanos;
+    return nextPulseNanos;
+}
+
+bool LoadGenerator::clockDue() const 
+{
+    return (options.profiles & LoadProfile::Clock) && (timeNanos >= nextPulseNanos);
+}
+
+int LoadGenerator::nextByte()
+{
+    if (heldByte >= 0)
+    {
+        Byte byte = heldByte;
+        heldByte = -1;
+        statistics.bytes++;
+        timeNanos += options.byteNanos;
+        return byte;
+    }
+    int byte = nextRawByte();
+    if ((byte >= 0) && options.corruptionPpm && random.chance(options.corruptionPpm))
+    {
+        statistics.corruptedBytes++;
+        switch (random.below(3))
+        {
+            case 0:
+                byte ^= 1 << random.below(8);
+                break;
+            case 1:
+                byte = nextRawByte();
+                break;
+            default:
+                heldByte = byte;
+                byte = random.below(256);
+                break;
+        }
+    }
+    if (byte >= 0) 
+    {
+        statistics.bytes++;
+        timeNanos += options.byteNanos;
+    }
+    return byte;
+}
+
+unsigned int LoadGenerator::generate(Byte* data, unsigned int length)
+{
+    for (unsigned int i = 0; i < length; i++)
+    {
+        int byte = nextByte();
+        if (byte < 0) return i;
+        data[i] = byte;
+    }
+    return length;
+}
+
+int LoadGenerator::nextRawByte()
+{
+    if (!trafficProfiles && !clockDue())
+    {
+        if (!(options.profiles & LoadProfile::Clock)) return -1;
+        //Idle until the next pulse
+        timeNanos = nextPulseNanos;
+    }
+    if (clockDue())
+    {
+        nextPulseNanos += pulseNanos;
+        statistics.messages++;
+        return 0xF8;
+    }
+    if (pendingIndex < pendingLength) return pending[pendingIndex++];
+    if (sysExRemaining)
+    {
+        sysExRemaining--;
+        return random.below(128);
+    }
+    if (sysExEndPending)
+    {
+        sysExEndPending = false;
+        statistics.messages++;
+        return 0xF7;
+    }
+    startEvent();
+    if (pendingIndex >= pendingLength) return -1;
+    return pending[pendingIndex++];
+}
+
+void LoadGenerator::startEvent()
+{
+    pendingIndex = 0;
+    pendingLength = 0;
+    Byte profile = pickProfile(trafficProfiles);
+    if (profile == LoadProfile::SysExBursts)
+    {
+        pending[0] = 0xF0;
+        pending[1] = LoadSysExId;
+        pendingLength = 2;
+        sysExRemaining = random.below(options.maxSysExLength + 1);
+        sysExEndPending = true;
+        lastStatus = 0;
+        return;
+    }
+    Message msg = trafficMessage(profile);
+    if (!msg.isValid()) return;
+    Byte status = msg.getByte(0);
+    unsigned int length = msg.byteLength();
+    if (options.runningStatus && (status == lastStatus))
+    {
+        statistics.runningStatusBytesSaved++;
+    }
+    else pending[pendingLength++] = status;
+    lastStatus = status;
+    for (unsigned int i = 1; i < length; i++) pending[pendingLength++] = msg.getByte(i);
+    statistics.messages++;
+}
+
+Message LoadGenerator::nextMessage()
+{
+    if (clockDue())
+    {
+        nextPulseNanos += pulseNanos;
+        statistics.messages++;
+        timeNanos += options.byteNanos;
+        return Message(StatusByte(0xF8));
+    }
+    Byte profiles = trafficProfiles & ~LoadProfile::SysExBursts;
+    if (!profiles)
+    {
+        if (!(options.profiles & LoadProfile::Clock)) return Message::invalid();
+        timeNanos = nextPulseNanos;
+        return nextMessage();
+    }
+    Message msg = trafficMessage(pickProfile(profiles));
+    statistics.messages++;
+    timeNanos += options.byteNanos * msg.byteLength();
+    return msg;
+}
+
+Byte LoadGenerator::pickProfile(Byte enabled)
+{
+    unsigned int count = __builtin_popcount(enabled);
+    if (count == 0) return 0;
+    unsigned int choice = random.below(count);
+    for (Byte profile = 1; profile; profile <<= 1)
+    {
+        if (!(enabled & profile)) continue;
+        if (choice-- == 0) return profile;
+    }
+    return 0;
+}
+
+Message LoadGenerator::trafficMessage(Byte profile)
+{
+    switch (profile)
+    {
+        case LoadProfile::ControlSweeps:
+            return sweepMessage();
+        case LoadProfile::Chords:
+            return chordMessage();
+        case LoadProfile::MpeExpression:
+            return mpeMessage();
+        default:
+            return Message::invalid();
+    }
+}
+
+Message LoadGenerator::sweepMessage()
+{
+    Byte status = 0xB0 | sweepChannel;
+    if (sweepLsbPending)
+    {
+        //The LSB controller is 32 above its MSB
+        sweepLsbPending = false;
+        Message msg(status, sweepController + 32, sweepValue & 0x7F);
+        //Move on to the next channel, and a new controller after a lap
+        sweepChannel = (sweepChannel + 1) & 0x0F;
+        if (sweepChannel == 0) 
+        {
+            int step = 1 + random.below(64);
+            int value = sweepValue + (sweepRising ? step : -step);
+            if (value > 16383 || value < 0)
+            {
+                sweepRising = !sweepRising;
+                value = sweepRising ? 0 : 16383;
+                sweepController = 1 + random.below(31);
+            }
+            sweepValue = value;
+        }
+        return msg;
+    }
+    sweepLsbPending = true;
+    return Message(status, sweepController, sweepValue >> 7);
+}
+
+Message LoadGenerator::chordMessage()
+{
+    if (chordIndex == 0 && !chordOn)
+    {
+        //A new chord: ten notes spread over about three octaves
+        chordChannel = random.below(16);
+        Byte note = 24 + random.below(48);
+        for (unsigned int i = 0; i < ChordSize; i++)
+        {
+            chordNotes[i] = note;
+            note += 2 + random.below(4);
+        }
+    }
+    Byte note = chordNotes[chordIndex];
+    //Note off as a zero velocity note on, so running status applies
+    Byte velocity = chordOn ? 0 : (1 + random.below(127));
+    if (++chordIndex == ChordSize)
+    {
+        chordIndex = 0;
+        chordOn = !chordOn;
+    }
+    return Message(0x90 | chordChannel, note, velocity);
+}
+
+Message LoadGenerator::mpeMessage()
+{
+    //Member channels 2 to 16 of the lower zone
+    unsigned int member = random.below(MpeChannels);
+    Byte channel = member + 1;
+    Byte& note = mpeNotes[member];
+    if (note == 0)
+    {
+        note = 36 + random.below(60);
+        return Message(0x90 | channel, note, 1 + random.below(127));
+    }
+    switch (random.below(16))
+    {
+        case 0:
+        {
+            Message msg(0x80 | channel, note, random.below(128));
+            note = 0;
+            return msg;
+        }
+        case 1: case 2: case 3: case 4: case 5:
+        {
+            uint16_t bend = random.below(16384);
+            return Message(0xE0 | channel, bend & 0x7F, bend >> 7);
+        }
+        case 6: case 7: case 8: case 9: case 10:
+            return Message(0xD0 | channel, random.below(128));
+        default:
+            return Message(0xB0 | channel, 74, random.below(128));
+    }
+}
+
+int LoadTransmitter::getNextByte()
+{
+    if (isFinished()) return -1;
+    if (sim)
+    {
+        uint64_t due = generator.nextByteNanos();
+        if (due > sim->now())
+        {
+            if (!isScheduled()) sim->schedule(*this, due);
+            return -1;
+        }
+    }
+    int byte = generator.nextByte();
+    if (byte >= 0) sent++;
+    return byte;
+}
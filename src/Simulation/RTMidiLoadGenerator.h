@@ -0,0 +1,354 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiLoadGenerator.h 
+//!  @brief Reproducible synthetic MIDI traffic for benchmarks and simulations
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_SIMULATION_LOAD_GENERATOR_H_
+#define _RT_MIDI_SIMULATION_LOAD_GENERATOR_H_
+
+#include "../Core/RTMidiCore.h"
+#include "../Output/RTMidiTxHandler.h"
+#include "./RTMidiSimulator.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Small, fast xorshift pseudo random generator.  The same seed 
+     *        always gives the same sequence on every platform.
+     */
+    class SeededRandom 
+    {
+        public:
+            SeededRandom(uint32_t seed = 1){ reseed(seed); };
+
+            //xorshift has one bad seed, 0
+            void reseed(uint32_t seed){ state = seed ? seed : 0x9E3779B9; };
+
+            uint32_t next()
+            {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                return state;
+            }
+
+            /**
+             * @brief Get a number from 0 to range - 1.
+             */
+            uint32_t below(uint32_t range)
+            {
+                return (static_cast<uint64_t>(next()) * range) >> 32;
+            }
+
+            /**
+             * @brief Return true with a probability in parts per million.
+             */
+            bool chance(uint32_t partsPerMillion)
+            {
+                return below(1000000) < partsPerMillion;
+            }
+        protected:
+            uint32_t state;
+    };
+
+    /**
+     * @brief The kinds of traffic a LoadGenerator produces.  They can be 
+     *        combined; each event is one of the enabled kinds chosen at 
+     *        random, except Clock, which is interleaved by time.
+     */
+    namespace LoadProfile 
+    {
+        enum Type: Byte 
+        {
+            //14 bit controller sweeps (MSB and LSB pairs) on every channel
+            ControlSweeps = 0x01,
+            //10 note chords on and off, suited to running status
+            Chords = 0x02,
+            //Timing clock at LoadOptions::tempoBpm, even inside SysEx
+            Clock = 0x04,
+            //Non-commercial SysEx messages of random length
+            SysExBursts = 0x08,
+            //MPE lower zone: notes with per-note pitch bend, pressure and 
+            //timbre (CC 74) on channels 2 to 16
+            MpeExpression = 0x10,
+            All = 0x1F
+        };
+    }
+
+    struct LoadOptions 
+    {
+        //Combination of LoadProfile values
+        Byte profiles;
+        uint32_t seed;
+        //Leave out repeated channel status bytes
+        bool runningStatus;
+        //Chance of corrupting each byte, in parts per million.  A 
+        //corrupted byte has a bit flipped, is dropped or has a random 
+        //byte inserted before it.
+        uint32_t corruptionPpm;
+        uint32_t tempoBpm;
+        //The longest SysEx data, not counting F0, the ID and F7
+        unsigned int maxSysExLength;
+        //Time per byte.  The default is the MIDI wire rate.
+        uint32_t byteNanos;
+
+        LoadOptions(Byte profiles = LoadProfile::All, uint32_t seed = 1):
+            profiles(profiles), seed(seed), runningStatus(true), 
+            corruptionPpm(0), tempoBpm(300), maxSysExLength(64), 
+            byteNanos(320000){};
+    };
+
+    struct LoadStatistics 
+    {
+        uint64_t messages;
+        uint64_t bytes;
+        uint64_t runningStatusBytesSaved;
+        uint64_t corruptedBytes;
+    };
+
+    /**
+     * @brief Produces reproducible synthetic traffic as a byte stream or 
+     *        as messages.
+     * 
+     *        The stream saturates the link: time advances by byteNanos for 
+     *        every byte, and only a Clock-only generator is ever idle.  
+     *        Generating allocates nothing, so the generator can also run 
+     *        on the target to load a real port.
+     */
+    class LoadGenerator 
+    {
+        public:
+            LoadGenerator(const LoadOptions& options = LoadOptions());
+
+            /**
+             * @brief Start the stream again from the beginning.  The same 
+             *        options always give the same stream.
+             */
+            void reset();
+
+            /**
+             * @brief Get the next byte of the stream.
+             * 
+             * @return The byte, or -1 if no profile is enabled
+             */
+            int nextByte();
+
+            /**
+             * @brief Fill a buffer with the next bytes of the stream.
+             * 
+             * @return The number of bytes written
+             */
+            unsigned int generate(Byte* data, unsigned int length);
+
+            /**
+             * @brief Get the next whole message, for consumers that take 
+             *        messages rather than bytes.  SysEx is left out, as is 
+             *        corruption, and running status does not apply.
+             * 
+             * @return The message, or an invalid message if only 
+             *         SysExBursts is enabled
+             */
+            Message nextMessage();
+
+            /**
+             * @brief Push bytes into a byte ring buffer until it is full.
+             * 
+             * @return The number of bytes pushed
+             */
+            template<class BUFFER>
+            unsigned int fillBytes(BUFFER& buffer, unsigned int limit = ~0u)
+            {
+                unsigned int count = 0;
+                while ((count < limit) && !buffer.isFull())
+                {
+                    int byte = nextByte();
+                    if (byte < 0) break;
+                    buffer.push(static_cast<Byte>(byte));
+                    count++;
+                }
+                return count;
+            }
+
+            /**
+             * @brief Push messages into a message ring buffer until it is 
+             *        full.
+             * 
+             * @return The number of messages pushed
+             */
+            template<class BUFFER>
+            unsigned int fillMessages(BUFFER& buffer, unsigned int limit = ~0u)
+            {
+                unsigned int count = 0;
+                while ((count < limit) && !buffer.isFull())
+                {
+                    Message msg = nextMessage();
+                    if (!msg.isValid()) break;
+                    buffer.push(msg);
+                    count++;
+                }
+                return count;
+            }
+
+            /**
+             * @brief Get the time at which the next byte is due.
+             */
+            uint64_t nextByteNanos() const;
+
+            const LoadStatistics& getStatistics() const { return statistics; };
+
+            const LoadOptions& getOptions() const { return options; };
+        protected:
+            static constexpr unsigned int MpeChannels = 15;
+            static constexpr unsigned int ChordSize = 10;
+
+            LoadOptions options;
+            SeededRandom random;
+            LoadStatistics statistics;
+            uint64_t timeNanos;
+            uint64_t pulseNanos;
+            uint64_t nextPulseNanos;
+            Byte trafficProfiles;
+
+            //Bytes of the current event still to send
+            Byte pending[3];
+            Byte pendingLength;
+            Byte pendingIndex;
+            unsigned int sysExRemaining;
+            bool sysExEndPending;
+            Byte lastStatus;
+            int heldByte;
+
+            //ControlSweeps
+            Byte sweepChannel;
+            Byte sweepController;
+            uint16_t sweepValue;
+            bool sweepRising;
+            bool sweepLsbPending;
+
+            //Chords
+            Byte chordChannel;
+            Byte chordNotes[ChordSize];
+            Byte chordIndex;
+            bool chordOn;
+
+            //MpeExpression: the note sounding on each member channel, or 0
+            Byte mpeNotes[MpeChannels];
+
+            int nextRawByte();
+            bool clockDue() const;
+            void startEvent();
+            Message trafficMessage(Byte profile);
+            Message sweepMessage();
+            Message chordMessage();
+            Message mpeMessage();
+            Byte pickProfile(Byte enabled);
+    };
+
+    /**
+     * @brief Transmitter that sends a LoadGenerator's stream, for 
+     *        connecting a generator to a VirtualUart or a real port.
+     * 
+     *        With a simulator the bytes are offered at the generator's 
+     *        times; without one they are offered as fast as they are taken.
+     *        Create the transmitter before running the simulator.
+     */
+    class LoadTransmitter: public TxHandler, public SimulationProcess 
+    {
+        public:
+            /**
+             * @param generator The stream
+             * @param simulator (optional) The simulator giving the time
+             * @param byteLimit (optional) Stop after this many bytes, 0 
+             *                  for no limit
+             */
+            LoadTransmitter(LoadGenerator& generator, 
+                            Simulator* simulator = nullptr, 
+                            uint64_t byteLimit = 0):
+                generator(generator), sim(simulator), 
+                limit(byteLimit), sent(0)
+            {
+                //Wake the link for the first byte
+                if (sim) sim->schedule(*this, generator.nextByteNanos());
+            }
+
+            int getNextByte() override;
+
+            /**
+             * @brief Ignored, the transmitter only sends the generated 
+             *        stream.
+             */
+            void sendMessage(Message msg) override {};
+
+            uint64_t getBytesSent() const { return sent; };
+
+            bool isFinished() const { return limit && (sent >= limit); };
+
+            //Only scheduled to wake the link when the next byte is due
+            void run(Simulator& simulator) override {};
+        protected:
+            LoadGenerator& generator;
+            Simulator* sim;
+            uint64_t limit;
+            uint64_t sent;
+
+            Message getNextMessage() override { return Message::invalid(); };
+            void restartTransmission() override {};
+    };
+}
+
+#endif
@@ -0,0 +1,156 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiParserCheck.cpp 
+//!  @brief Checks the parser against seeded, randomly corrupted MIDI streams
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiParserCheck.h"
+
+using namespace RTMIDI;
+
+constexpr unsigned int ParserCheck::MatrixRuns;
+
+ParserCheck::ParserCheck(ParserMode mode): 
+    parsed(0), violations(0), aborted(0), sysExOpen(false)
+{
+    setParserMode(mode);
+}
+
+ParserCheckReport ParserCheck::run(const LoadOptions& options, 
+                                   ParserMode mode, 
+                                   uint64_t bytes)
+{
+    LoadGenerator generator(options);
+    ParserCheck parser(mode);
+    //The generator counts a message when it starts it, so run on to the 
+    //end of the message in progress.  A corrupted stream gets a limit.
+    uint64_t limit = bytes + 1024;
+    for (uint64_t i = 0; (i < bytes) || (parser.isMidMessage() && (i < limit)); i++)
+    {
+        int byte = generator.nextByte();
+        if (byte < 0) break;
+        parser.receiveByte(static_cast<Byte>(byte));
+    }
+    ParserCheckReport report;
+    report.mode = mode;
+    report.corruptionPpm = options.corruptionPpm;
+    report.bytes = generator.getStatistics().bytes;
+    report.corruptedBytes = generator.getStatistics().corruptedBytes;
+    report.generatedMessages = generator.getStatistics().messages;
+    report.parsedMessages = parser.parsed;
+    report.violations = parser.violations;
+    report.abortedSysEx = parser.aborted;
+    for (Byte i = 0; i < ParserErrorCount; i++)
+    {
+        report.errors[i] = parser.getErrorCount(static_cast<ParserError>(i));
+    }
+    report.totalErrors = parser.getTotalErrors();
+    return report;
+}
+
+bool ParserCheck::runMatrix(uint32_t seed, uint64_t bytes, 
+                            ParserCheckReport* reports)
+{
+    static constexpr uint32_t Rates[] = {0, 1000, 20000, 200000};
+    static constexpr ParserMode Modes[] = {ParserMode::Lenient, ParserMode::Strict};
+    bool passed = true;
+    unsigned int index = 0;
+    for (ParserMode mode : Modes)
+    {
+        for (uint32_t rate : Rates)
+        {
+            LoadOptions options(LoadProfile::All, seed);
+            options.corruptionPpm = rate;
+            ParserCheckReport report = run(options, mode, bytes);
+            if (!report.passed()) passed = false;
+            if (reports) reports[index] = report;
+            index++;
+        }
+    }
+    return passed;
+}
+
+void ParserCheck::standardMessageReceived(Message msg)
+{
+    parsed++;
+    if (!msg.isWellFormed() || msg.getStatus().isSystemRealtime()) violations++;
+}
+
+void ParserCheck::realtimeMessageReceived(Message msg, Word timestamp)
+{
+    parsed++;
+    if (!msg.isWellFormed() || !msg.getStatus().isSystemRealtime()) violations++;
+}
+
+void ParserCheck::sysExStatusChanged(bool terminated, bool startedOrValid)
+{
+    if (terminated)
+    {
+        if (!sysExOpen) violations++;
+        sysExOpen = false;
+        if (startedOrValid) parsed++;
+        else aborted++;
+        return;
+    }
+    if (sysExOpen || !startedOrValid) violations++;
+    sysExOpen = true;
+}
+
+void ParserCheck::sysExByteReceived(Byte byte)
+{
+    if (!sysExOpen || DataByte::isStatusByte(byte)) violations++;
+}
@@ -0,0 +1,172 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiParserCheck.h 
+//!  @brief Checks the parser against seeded, randomly corrupted MIDI streams
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_SIMULATION_PARSER_CHECK_H_
+#define _RT_MIDI_SIMULATION_PARSER_CHECK_H_
+
+#include "../Core/RTMidiCore.h"
+#include "../Input/RTMidiStaticRxHandler.h"
+#include "./RTMidiLoadGenerator.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief The result of one ParserCheck run.
+     */
+    struct ParserCheckReport 
+    {
+        ParserMode mode;
+        uint32_t corruptionPpm;
+        uint64_t bytes;
+        uint64_t corruptedBytes;
+        //Messages in the stream, and messages the parser delivered.  They 
+        //only have to match for a clean stream.
+        uint64_t generatedMessages;
+        uint64_t parsedMessages;
+        //Malformed messages, stray SysEx bytes and unpaired SysEx 
+        //start/end reports.  Must always be 0.
+        uint64_t violations;
+        //SysEx messages reported as ended but not valid
+        uint64_t abortedSysEx;
+        Word errors[ParserErrorCount];
+        Word totalErrors;
+
+        /**
+         * @brief Check the run met every rule:
+         *          - the parser never delivered anything malformed
+         *          - every aborted SysEx was counted as AbortedSysEx
+         *          - a clean stream gave no errors and every message
+         */
+        bool passed() const 
+        {
+            if (violations != 0) return false;
+            Word aborted = errors[static_cast<Byte>(ParserError::AbortedSysEx)];
+            if (abortedSysEx != aborted) return false;
+            if (corruptedBytes != 0) return true;
+            return (totalErrors == 0) && (parsedMessages == generatedMessages);
+        }
+    };
+
+    /**
+     * @brief Feeds a LoadGenerator stream, optionally corrupted, through 
+     *        StaticRxHandler and checks everything it delivers.
+     * 
+     *        Whatever the input, every message delivered must be well 
+     *        formed, SysEx data bytes must only arrive between a SysEx 
+     *        start and end, and the error counters must agree with what 
+     *        was delivered.  The generator is seeded, so a failing run can 
+     *        be repeated exactly.
+     * 
+     *          ParserCheckReport reports[ParserCheck::MatrixRuns];
+     *          bool ok = ParserCheck::runMatrix(1234, 1000000, reports);
+     */
+    class ParserCheck: public StaticRxHandler<ParserCheck>
+    {
+        public:
+            //Two parser modes at each of the matrix corruption rates
+            static constexpr unsigned int MatrixRuns = 8;
+
+            /**
+             * @brief Check one stream.
+             * 
+             * @param options The stream, including its corruption rate
+             * @param mode The parser mode to check
+             * @param bytes The length of the stream
+             * @return The report
+             */
+            static ParserCheckReport run(const LoadOptions& options, 
+                                         ParserMode mode, 
+                                         uint64_t bytes);
+
+            /**
+             * @brief Check both parser modes with clean streams and with 
+             *        0.1%, 2% and 20% of bytes corrupted.
+             * 
+             * @param seed The generator seed
+             * @param bytes The length of each stream
+             * @param reports (optional) Storage for MatrixRuns reports
+             * @return True if every run passed
+             */
+            static bool runMatrix(uint32_t seed, uint64_t bytes, 
+                                  ParserCheckReport* reports = nullptr);
+
+            ParserCheck(ParserMode mode);
+
+            void standardMessageReceived(Message msg);
+
+            void realtimeMessageReceived(Message msg, Word timestamp);
+
+            void sysExStatusChanged(bool terminated, bool startedOrValid);
+
+            void sysExByteReceived(Byte byte);
+        protected:
+            bool isMidMessage() const 
+            {
+                return sysExInProgress || statusPending || thirdByteExpected;
+            }
+
+            uint64_t parsed;
+            uint64_t violations;
+            uint64_t aborted;
+            bool sysExOpen;
+    };
+}
+
+#endif
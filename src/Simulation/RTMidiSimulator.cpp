@@ -0,0 +1,164 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiSimulator.cpp 
+//!  @brief Deterministic discrete event simulator in virtual time
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiSimulator.h"
+
+using namespace RTMIDI;
+
+void Simulator::attach(SimulationProcess& process)
+{
+    for (SimulationProcess* p = attachedList; p; p = p->nextAttached)
+    {
+        if (p == &process) return;
+    }
+    process.nextAttached = attachedList;
+    attachedList = &process;
+}
+
+void Simulator::detach(SimulationProcess& process)
+{
+    SimulationProcess** link = &attachedList;
+    while (*link)
+    {
+        if (*link == &process)
+        {
+            *link = process.nextAttached;
+            process.nextAttached = nullptr;
+            return;
+        }
+        link = &((*link)->nextAttached);
+    }
+}
+
+void Simulator::schedule(SimulationProcess& process, uint64_t atNanos)
+{
+    if (process.scheduled) cancel(process);
+    if (atNanos < currentNanos) atNanos = currentNanos;
+    process.dueNanos = atNanos;
+    process.scheduled = true;
+
+    //Insert after every event due at or before the same time, so that 
+    //simultaneous events run in the order they were scheduled
+    SimulationProcess** link = &scheduledList;
+    while (*link && ((*link)->dueNanos <= atNanos))
+    {
+        link = &((*link)->nextScheduled);
+    }
+    process.nextScheduled = *link;
+    *link = &process;
+}
+
+void Simulator::cancel(SimulationProcess& process)
+{
+    if (!process.scheduled) return;
+    SimulationProcess** link = &scheduledList;
+    while (*link)
+    {
+        if (*link == &process)
+        {
+            *link = process.nextScheduled;
+            break;
+        }
+        link = &((*link)->nextScheduled);
+    }
+    process.nextScheduled = nullptr;
+    process.scheduled = false;
+}
+
+bool Simulator::step()
+{
+    SimulationProcess* process = scheduledList;
+    if (!process) return false;
+    scheduledList = process->nextScheduled;
+    process->nextScheduled = nullptr;
+    process->scheduled = false;
+    currentNanos = process->dueNanos;
+    eventCount++;
+    process->run(*this);
+    pollAttached();
+    return true;
+}
+
+void Simulator::runUntil(uint64_t endNanos)
+{
+    while (scheduledList && (scheduledList->dueNanos <= endNanos))
+    {
+        step();
+    }
+    if (endNanos > currentNanos) currentNanos = endNanos;
+}
+
+bool Simulator::runUntilIdle(uint64_t limitNanos)
+{
+    while (scheduledList)
+    {
+        if (scheduledList->dueNanos > limitNanos) return false;
+        step();
+    }
+    return true;
+}
+
+void Simulator::pollAttached()
+{
+    for (SimulationProcess* p = attachedList; p; p = p->nextAttached)
+    {
+        if (!p->scheduled) p->poll(*this);
+    }
+}
@@ -0,0 +1,241 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiSimulator.h 
+//!  @brief Deterministic discrete event simulator in virtual time
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_SIMULATION_SIMULATOR_H_
+#define _RT_MIDI_SIMULATION_SIMULATOR_H_
+
+#include "../Core/RTMidiCore.h"
+
+namespace RTMIDI 
+{
+    class Simulator;
+
+    /**
+     * @brief Abstract class for anything that acts at points in virtual 
+     *        time, such as a UART or a firmware main loop.
+     */
+    class SimulationProcess 
+    {
+        friend class Simulator;
+        public:
+            SimulationProcess(): 
+                dueNanos(0), 
+                scheduled(false), 
+                nextScheduled(nullptr), 
+                nextAttached(nullptr){};
+
+            virtual ~SimulationProcess(){};
+
+            /**
+             * @brief Called when the time the process was scheduled for is 
+             *        reached.
+             */
+            virtual void run(Simulator& sim) = 0;
+
+            /**
+             * @brief Called after every event while the process is attached 
+             *        and not scheduled, so that idle processes can pick up 
+             *        work created by the event.
+             */
+            virtual void poll(Simulator& sim){};
+
+            bool isScheduled() const { return scheduled; };
+
+            uint64_t getDueTime() const { return dueNanos; };
+        private:
+            uint64_t dueNanos;
+            bool scheduled;
+            SimulationProcess* nextScheduled;
+            SimulationProcess* nextAttached;
+    };
+
+    /**
+     * @brief Runs simulation processes in virtual time.
+     * 
+     *        Events run in time order, and events due at the same time run 
+     *        in the order they were scheduled, so a simulation always gives 
+     *        the same results.  Time only advances between events, so a 
+     *        simulation runs as fast as the processes allow.
+     * 
+     *        Nothing here is thread safe: a simulation runs on one thread.
+     */
+    class Simulator 
+    {
+        public:
+            Simulator(): 
+                currentNanos(0), 
+                eventCount(0), 
+                scheduledList(nullptr), 
+                attachedList(nullptr){};
+
+            /**
+             * @brief Get the current virtual time in nanoseconds.
+             */
+            uint64_t now() const { return currentNanos; };
+
+            /**
+             * @brief Get the current virtual time in microseconds, as used 
+             *        for message timestamps.
+             */
+            Word nowMicros() const { return static_cast<Word>(currentNanos / 1000); };
+
+            /**
+             * @brief Attach a process so that it is polled after every 
+             *        event.  Processes that are only ever scheduled do not 
+             *        need to be attached.
+             */
+            void attach(SimulationProcess& process);
+
+            void detach(SimulationProcess& process);
+
+            /**
+             * @brief Schedule a process to run.  A process that is already 
+             *        scheduled is moved to the new time.
+             * 
+             * @param process The process
+             * @param atNanos The virtual time, which is clamped to now
+             */
+            void schedule(SimulationProcess& process, uint64_t atNanos);
+
+            /**
+             * @brief Schedule a process to run after a delay.
+             */
+            void scheduleIn(SimulationProcess& process, uint64_t delayNanos)
+            {
+                schedule(process, currentNanos + delayNanos);
+            }
+
+            void cancel(SimulationProcess& process);
+
+            /**
+             * @brief Run the next event.
+             * 
+             * @return False if no events are scheduled
+             */
+            bool step();
+
+            /**
+             * @brief Run events until a time, then advance to it.
+             */
+            void runUntil(uint64_t endNanos);
+
+            /**
+             * @brief Run events until none are scheduled.
+             * 
+             * @param limitNanos Stop at this time even if events remain, 
+             *        which guards against processes that never go idle
+             * @return True if the simulation went idle
+             */
+            bool runUntilIdle(uint64_t limitNanos = UINT64_MAX);
+
+            /**
+             * @brief Get the number of events run.
+             */
+            uint64_t getEventCount() const { return eventCount; };
+
+            /**
+             * @brief Poll every attached process that is not scheduled.  
+             *        This happens after every event, but must be called 
+             *        after changing state from outside the simulation, such 
+             *        as sending a message before it starts.
+             */
+            void pollAttached();
+        protected:
+            uint64_t currentNanos;
+            uint64_t eventCount;
+            SimulationProcess* scheduledList;
+            SimulationProcess* attachedList;
+    };
+
+    /**
+     * @brief A process that runs at a fixed period, such as a firmware 
+     *        main loop calling processMessages().
+     */
+    class PeriodicProcess: public SimulationProcess 
+    {
+        public:
+            PeriodicProcess(uint64_t periodNanos): period(periodNanos ? periodNanos : 1){};
+
+            /**
+             * @brief Start running, first at the given time.
+             */
+            void start(Simulator& sim, uint64_t firstNanos = 0)
+            {
+                sim.schedule(*this, firstNanos);
+            }
+
+            void stop(Simulator& sim){ sim.cancel(*this); };
+
+            void run(Simulator& sim) override 
+            {
+                tick(sim);
+                sim.scheduleIn(*this, period);
+            }
+
+            /**
+             * @brief Called once per period.
+             */
+            virtual void tick(Simulator& sim) = 0;
+        protected:
+            uint64_t period;
+    };
+}
+
+#endif
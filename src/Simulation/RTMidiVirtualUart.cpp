@@ -0,0 +1,124 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiVirtualUart.cpp 
+//!  @brief Simulated UART connecting a TxHandler to an RxHandler in virtual time
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#include "./RTMidiVirtualUart.h"
+
+using namespace RTMIDI;
+
+VirtualUart::VirtualUart(Simulator& sim, TxHandler& source, 
+                         RxHandler& sink, LinkSpeed speed):
+    simulator(sim),
+    transmitter(source),
+    receiver(sink),
+    byteNanos(speed.nanosPerByte()),
+    lineByte(-1),
+    lastEndNanos(UINT64_MAX)
+{
+    resetStatistics();
+    simulator.attach(*this);
+}
+
+VirtualUart::~VirtualUart()
+{
+    simulator.cancel(*this);
+    simulator.detach(*this);
+}
+
+unsigned int VirtualUart::getUtilisation() const 
+{
+    uint64_t elapsed = simulator.now() - statisticsStartNanos;
+    if (elapsed == 0) return 0;
+    return static_cast<unsigned int>((statistics.busyNanos * 1000) / elapsed);
+}
+
+void VirtualUart::resetStatistics()
+{
+    statistics.bytes = 0;
+    statistics.busyNanos = 0;
+    statistics.backToBackBytes = 0;
+    statisticsStartNanos = simulator.now();
+}
+
+void VirtualUart::run(Simulator& sim)
+{
+    //The stop bit of the byte on the line has ended
+    Byte byte = static_cast<Byte>(lineByte);
+    lineByte = -1;
+    lastEndNanos = sim.now();
+    statistics.bytes++;
+    statistics.busyNanos += byteNanos;
+    receiver.receiveByte(byte, sim.nowMicros());
+    startByte(sim);
+}
+
+void VirtualUart::poll(Simulator& sim)
+{
+    startByte(sim);
+}
+
+bool VirtualUart::startByte(Simulator& sim)
+{
+    int nextByte = transmitter.getNextByte();
+    if (nextByte < 0) return false;
+    if (lastEndNanos == sim.now()) statistics.backToBackBytes++;
+    lineByte = nextByte;
+    sim.scheduleIn(*this, byteNanos);
+    return true;
+}
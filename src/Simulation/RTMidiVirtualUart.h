@@ -0,0 +1,142 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiVirtualUart.h 
+//!  @brief Simulated UART connecting a TxHandler to an RxHandler in virtual time
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_SIMULATION_VIRTUAL_UART_H_
+#define _RT_MIDI_SIMULATION_VIRTUAL_UART_H_
+
+#include "../Core/RTMidiCore.h"
+#include "../Input/RTMidiRXHandler.h"
+#include "../Output/RTMidiTxHandler.h"
+#include "./RTMidiSimulator.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Counters for a VirtualUart.
+     */
+    struct UartStatistics 
+    {
+        //Bytes delivered to the receiver
+        uint64_t bytes;
+        //Virtual time spent transmitting
+        uint64_t busyNanos;
+        //Bytes sent back to back, with no idle time since the previous one
+        uint64_t backToBackBytes;
+    };
+
+    /**
+     * @brief Simulated serial link from a TxHandler to an RxHandler.
+     * 
+     *        Whenever the transmitter has a byte and the line is free, the 
+     *        byte is taken and delivered to the receiver one byte time 
+     *        later (10 bit times for a UART), just as a real UART raises 
+     *        its receive interrupt after the stop bit.  Bytes are timestamped 
+     *        with the virtual time in microseconds.
+     * 
+     *        The UART attaches itself to the simulator, so it notices new 
+     *        data after any event without needing restartTransmission().
+     */
+    class VirtualUart: public SimulationProcess 
+    {
+        public:
+            VirtualUart(Simulator& simulator, TxHandler& source, 
+                        RxHandler& sink, LinkSpeed speed = MidiLinkSpeed);
+
+            ~VirtualUart();
+
+            /**
+             * @brief Get the time one byte takes on the line.
+             */
+            uint32_t getByteNanos() const { return byteNanos; };
+
+            /**
+             * @brief Check whether a byte is being transmitted.
+             */
+            bool isBusy() const { return isScheduled(); };
+
+            UartStatistics getStatistics() const { return statistics; };
+
+            /**
+             * @brief Get the fraction of the elapsed virtual time the line 
+             *        was busy.
+             * 
+             * @return The utilisation in parts per thousand
+             */
+            unsigned int getUtilisation() const;
+
+            void resetStatistics();
+
+            void run(Simulator& sim) override;
+            void poll(Simulator& sim) override;
+        protected:
+            Simulator& simulator;
+            TxHandler& transmitter;
+            RxHandler& receiver;
+            uint32_t byteNanos;
+            int lineByte;
+            uint64_t lastEndNanos;
+            uint64_t statisticsStartNanos;
+            UartStatistics statistics;
+
+            bool startByte(Simulator& sim);
+    };
+}
+
+#endif
@@ -0,0 +1,526 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiMerger.h 
+//!  @brief Merges several parsed MIDI input streams into one output
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_THRU_MERGER_H_
+#define _RT_MIDI_THRU_MERGER_H_
+
+#include "../Core/RTMidiCore.h"
+#include "../Input/RTMidiStaticRxHandler.h"
+#include "../Output/RTMidiTxHandler.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Merges the MIDI streams of SOURCES inputs into one output byte
+     *        stream.
+     * 
+     *        Each input is parsed by its own MergeInput, and the merger 
+     *        interleaves the results at message boundaries only, so no 
+     *        message is ever split by another.  Selection rules:
+     * 
+     *          - Realtime bytes go first.  They may be sent in the middle 
+     *            of any message, as MIDI allows.
+     *          - When a SysEx message is selected, the output is locked to 
+     *            its source until its SysEx End has been sent.  If that 
+     *            source stalls mid SysEx for longer than the SysEx timeout, 
+     *            checkTimeouts() ends the output SysEx with a SysEx End and 
+     *            the rest of that source's SysEx is discarded.
+     *          - Otherwise the queued message with the oldest timestamp is 
+     *            sent next.  Ties are broken round robin, so no source can 
+     *            starve the others.
+     * 
+     *        All timestamps must come from the same clock.  Buffering is 
+     *        bounded per source.  The output is a single link, so inputs 
+     *        that are busier than the output together will overflow their 
+     *        queues.  Full queues drop whole messages, and a SysEx that 
+     *        overflows its buffer is cut short and terminated, so the 
+     *        output stream always stays well formed.  Drops are counted 
+     *        in each source's statistics.
+     * 
+     *        Messages sent to the merger itself with sendMessage() form one 
+     *        more source, numbered SOURCES.  They are timestamped with the 
+     *        most recent input timestamp.
+     * 
+     *        The derived class must implement restartTransmission() as for 
+     *        any TxHandler.
+     * 
+     * @tparam SOURCES The number of inputs (at most 254)
+     * @tparam QUEUE_LENGTH The message queue length of each input
+     * @tparam SYSEX_LENGTH The SysEx byte buffer length of each input
+     */
+    template<unsigned int SOURCES, 
+             unsigned int QUEUE_LENGTH = 16, 
+             unsigned int SYSEX_LENGTH = 64>
+    class Merger: public TxHandler
+    {
+        static_assert((SOURCES > 0) && (SOURCES < 255), 
+                      "A Merger supports 1 to 254 sources");
+        static_assert((QUEUE_LENGTH <= 256) && (SYSEX_LENGTH <= 256), 
+                      "Merger buffers are limited to 256 entries");
+        static_assert(SYSEX_LENGTH >= 4, 
+                      "The SysEx buffer must hold at least 4 bytes");
+
+        public:
+            static constexpr Byte NoSource = 0xFF;
+            static constexpr Byte LocalSource = SOURCES;
+            static constexpr unsigned int RealtimeQueueLength = 4;
+
+            /**
+             * @brief Counts of everything a source lost.
+             */
+            struct SourceStats 
+            {
+                Word messagesDropped;
+                Word realtimeDropped;
+                Word sysExTruncated;
+                Word sysExTimeouts;
+            };
+
+            /**
+             * @brief Construct a new Merger
+             * 
+             * @param sysExTimeoutTicks How long a source may stall in the 
+             *                          middle of a SysEx message, in 
+             *                          timestamp units.  0 never times out.
+             */
+            Merger(Word sysExTimeoutTicks = 0): 
+                sources(),
+                sysExOwner(NoSource),
+                nextSource(0),
+                nextRealtimeSource(0),
+                transmitting(0),
+                abortPending(false),
+                sysExTimeout(sysExTimeoutTicks),
+                lastTimestamp(0){};
+
+            void setSysExTimeout(Word ticks){ sysExTimeout = ticks; };
+
+            /**
+             * @brief Send a message from the local source.
+             */
+            void sendMessage(Message msg) override 
+            {
+                if (msg.getStatus().isSystemRealtime())
+                {
+                    sourceRealtime(LocalSource, msg.getStatus());
+                }
+                else sourceMessage(LocalSource, msg, lastTimestamp);
+            }
+
+            int getNextByte() override
+            {
+                while (true)
+                {
+                    int nextByte = takeNextByte();
+                    if (nextByte >= 0) return nextByte;
+                    //Going idle.  Anything queued after takeNextByte() looked 
+                    //and before the flag was cleared found it still set and 
+                    //did not restart transmission, so look again.  Whichever 
+                    //side sets the flag first carries on transmitting.
+                    transmitting.store(false);
+                    if (!hasPendingBytes()) return -1;
+                    if (transmitting.exchange(true)) return -1;
+                }
+            }
+
+            /**
+             * @brief Check if the source the output is locked to has 
+             *        stalled in the middle of a SysEx message.  Call this 
+             *        regularly from the main loop when a SysEx timeout is set.
+             * 
+             * @param now The current time
+             */
+            void checkTimeouts(Word now)
+            {
+                Byte owner = sysExOwner;
+                if ((owner == NoSource) || (sysExTimeout == 0)) return;
+                if ((now - sources[owner].lastByteTime) > sysExTimeout)
+                {
+                    abortPending = true;
+                    wake();
+                }
+            }
+
+            /**
+             * @brief Get the source the output is locked to while it sends 
+             *        a SysEx message, or NoSource.
+             */
+            Byte getSysExOwner() const { return sysExOwner; };
+
+            const SourceStats& getStats(Byte source) const 
+            {
+                return sources[source].stats;
+            }
+
+            /*
+             * The following are called by MergeInput from the receive 
+             * context of each source.
+             */
+
+            void sourceMessage(Byte source, Message msg, Word timestamp)
+            {
+                Source& src = sources[source];
+                lastTimestamp = timestamp;
+                if (src.queue.isFull())
+                {
+                    src.stats.messagesDropped++;
+                    return;
+                }
+                src.queue.push(Entry{msg, timestamp});
+                wake();
+            }
+
+            void sourceRealtime(Byte source, Byte status)
+            {
+                Source& src = sources[source];
+                if (src.realtime.isFull())
+                {
+                    src.stats.realtimeDropped++;
+                    return;
+                }
+                src.realtime.push(status);
+                wake();
+            }
+
+            void sourceSysExStart(Byte source, Word timestamp)
+            {
+                Source& src = sources[source];
+                if (src.inSysEx) sourceSysExEnd(source);
+                lastTimestamp = timestamp;
+                src.inSysEx = true;
+                src.seenAborts = src.aborts;
+                src.lastByteTime = timestamp;
+                //Always keep one byte free for the SysEx End
+                if (src.queue.isFull() || (src.sysEx.freeSpace() < 2))
+                {
+                    src.discarding = true;
+                    src.stats.sysExTruncated++;
+                    return;
+                }
+                src.discarding = false;
+                src.queue.push(Entry{Message(SystemCommonCode::SysExStart), 
+                                     timestamp});
+                wake();
+            }
+
+            void sourceSysExByte(Byte source, Byte data, Word timestamp)
+            {
+                Source& src = sources[source];
+                if (!src.inSysEx || src.discarding) return;
+                if ((src.seenAborts != src.aborts) || 
+                    (src.sysEx.freeSpace() < 2))
+                {
+                    //Timed out or overflowed, end it here and drop the rest
+                    if (src.seenAborts == src.aborts) 
+                    {
+                        src.stats.sysExTruncated++;
+                    }
+                    src.seenAborts = src.aborts;
+                    src.sysEx.push(SysExEnd);
+                    src.discarding = true;
+                }
+                else src.sysEx.push(data);
+                src.lastByteTime = timestamp;
+                wake();
+            }
+
+            void sourceSysExEnd(Byte source)
+            {
+                Source& src = sources[source];
+                if (!src.inSysEx) return;
+                src.inSysEx = false;
+                if (src.discarding) return;
+                src.sysEx.push(SysExEnd);
+                wake();
+            }
+
+        protected:
+            static constexpr unsigned int SourceCount = SOURCES + 1;
+            static constexpr Byte SysExEnd = 
+                static_cast<Byte>(SystemCommonCode::SysExEnd);
+
+            struct Entry 
+            {
+                Message msg;
+                Word timestamp;
+            };
+
+            struct Source 
+            {
+                RingBuffer<Entry, QUEUE_LENGTH, uint8_t> queue;
+                RingBuffer<Byte, SYSEX_LENGTH, uint8_t> sysEx;
+                RingBuffer<Byte, RealtimeQueueLength, uint8_t> realtime;
+                volatile Word lastByteTime;
+                //Written by the receive side
+                bool inSysEx;
+                bool discarding;
+                Byte seenAborts;
+                //Written by the transmit side
+                volatile Byte aborts;
+                bool skipping;
+                SourceStats stats;
+            };
+
+            Source sources[SourceCount];
+            volatile Byte sysExOwner;
+            Byte nextSource;
+            Byte nextRealtimeSource;
+            Atomic<Byte> transmitting;
+            volatile bool abortPending;
+            Word sysExTimeout;
+            volatile Word lastTimestamp;
+
+            void wake()
+            {
+                if (transmitting.exchange(true)) return;
+                restartTransmission();
+            }
+
+            int takeNextByte()
+            {
+                int nextByte = getNextRealtimeByte();
+                if (nextByte >= 0) return nextByte;
+                nextByte = getNextMessageByte();
+                if (nextByte >= 0) return nextByte;
+                if (sysExOwner != NoSource)
+                {
+                    nextByte = getNextSysExByte();
+                    if (nextByte >= 0) return nextByte;
+                    //Still waiting for the owner's next SysEx byte
+                    if (sysExOwner != NoSource) return -1;
+                }
+                if (!loadNextMessage()) return -1;
+                return getNextMessageByte();
+            }
+
+            /**
+             * @brief Check if takeNextByte() could now return a byte.
+             */
+            bool hasPendingBytes()
+            {
+                if (realTimeByte) return true;
+                for (unsigned int i = 0; i < SourceCount; i++)
+                {
+                    if (sources[i].realtime.available()) return true;
+                }
+                Byte owner = sysExOwner;
+                if (owner != NoSource)
+                {
+                    return abortPending || sources[owner].sysEx.available();
+                }
+                for (unsigned int i = 0; i < SourceCount; i++)
+                {
+                    //A source skipping an aborted SysEx can only make 
+                    //progress once more of that SysEx has arrived
+                    Source& src = sources[i];
+                    if (src.skipping ? src.sysEx.available() : 
+                                       src.queue.available()) return true;
+                }
+                return false;
+            }
+
+            int getNextRealtimeByte()
+            {
+                if (realTimeByte)
+                {
+                    Byte nextByte = realTimeByte;
+                    realTimeByte = 0;
+                    return nextByte;
+                }
+                for (unsigned int i = 0; i < SourceCount; i++)
+                {
+                    Byte index = (nextRealtimeSource + i) % SourceCount;
+                    if (sources[index].realtime.available())
+                    {
+                        nextRealtimeSource = (index + 1) % SourceCount;
+                        return sources[index].realtime.pop();
+                    }
+                }
+                return -1;
+            }
+
+            int getNextSysExByte()
+            {
+                Source& src = sources[sysExOwner];
+                if (src.sysEx.available())
+                {
+                    Byte nextByte = src.sysEx.pop();
+                    if (nextByte == SysExEnd) 
+                    {
+                        sysExOwner = NoSource;
+                    }
+                    return nextByte;
+                }
+                if (!abortPending) return -1;
+                //The owner stalled, so end the SysEx on the output and skip
+                //whatever the owner still has to send of it.
+                abortPending = false;
+                src.aborts = src.aborts + 1;
+                src.skipping = true;
+                src.stats.sysExTimeouts++;
+                sysExOwner = NoSource;
+                return SysExEnd;
+            }
+
+            void skipAbortedSysEx(Source& src)
+            {
+                while (src.sysEx.available())
+                {
+                    if (src.sysEx.pop() == SysExEnd)
+                    {
+                        src.skipping = false;
+                        return;
+                    }
+                }
+            }
+
+            Message getNextMessage() override
+            {
+                Byte selected = NoSource;
+                Word oldest = 0;
+                for (unsigned int i = 0; i < SourceCount; i++)
+                {
+                    Byte index = (nextSource + i) % SourceCount;
+                    Source& src = sources[index];
+                    if (src.skipping) skipAbortedSysEx(src);
+                    if (src.skipping || !src.queue.available()) continue;
+                    Word timestamp = src.queue.peek().timestamp;
+                    //Compare through the difference so that the clock may 
+                    //wrap around.  Ties keep the earlier source in the 
+                    //round robin order.
+                    if ((selected == NoSource) || 
+                        (static_cast<int32_t>(timestamp - oldest) < 0))
+                    {
+                        selected = index;
+                        oldest = timestamp;
+                    }
+                }
+                if (selected == NoSource) return Message::invalid();
+                nextSource = (selected + 1) % SourceCount;
+                Message msg = sources[selected].queue.pop().msg;
+                if (msg.getStatus().isSystemCommonCode(SystemCommonCode::SysExStart))
+                {
+                    abortPending = false;
+                    sysExOwner = selected;
+                }
+                return msg;
+            }
+    };
+
+    template<unsigned int SOURCES, unsigned int QUEUE_LENGTH, unsigned int SYSEX_LENGTH>
+    constexpr Byte Merger<SOURCES, QUEUE_LENGTH, SYSEX_LENGTH>::NoSource;
+
+    template<unsigned int SOURCES, unsigned int QUEUE_LENGTH, unsigned int SYSEX_LENGTH>
+    constexpr Byte Merger<SOURCES, QUEUE_LENGTH, SYSEX_LENGTH>::LocalSource;
+
+    /**
+     * @brief A MIDI input that parses one byte stream into a Merger.
+     * 
+     *        Call receiveByte() from the input's receive interrupt with a 
+     *        timestamp from the clock shared by all of the merger's inputs.
+     * 
+     * @tparam MERGER The Merger class
+     */
+    template<class MERGER>
+    class MergeInput: public StaticRxHandler<MergeInput<MERGER>>
+    {
+        public:
+            MergeInput(MERGER& inputMerger, Byte sourceNumber):
+                merger(inputMerger), source(sourceNumber), timestamp(0){};
+
+            void receiveByte(Byte ip, Word time = 0)
+            {
+                timestamp = time;
+                StaticRxHandler<MergeInput<MERGER>>::receiveByte(ip, time);
+            }
+
+            void receiveMessage(Message msg, Word time = 0)
+            {
+                timestamp = time;
+                StaticRxHandler<MergeInput<MERGER>>::receiveMessage(msg, time);
+            }
+
+            void standardMessageReceived(Message msg)
+            {
+                merger.sourceMessage(source, msg, timestamp);
+            }
+
+            void realtimeMessageReceived(Message msg, Word time)
+            {
+                merger.sourceRealtime(source, msg.getStatus());
+            }
+
+            void sysExStatusChanged(bool terminated, bool startedOrValid)
+            {
+                if (terminated) merger.sourceSysExEnd(source);
+                else if (startedOrValid) merger.sourceSysExStart(source, timestamp);
+            }
+
+            void sysExByteReceived(Byte byte)
+            {
+                merger.sourceSysExByte(source, byte, timestamp);
+            }
+        protected:
+            MERGER& merger;
+            const Byte source;
+            Word timestamp;
+    };
+}
+#endif
@@ -0,0 +1,317 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiRouter.h 
+//!  @brief RTMIDI Router and RouterInput template class definitions
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_THRU_ROUTER_H_
+#define _RT_MIDI_THRU_ROUTER_H_
+
+#include "../Core/RTMidiCore.h"
+#include "../Input/RTMidiInputs.h"
+#include "../Output/RTMidiOutputs.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Routes messages from any of INPUTS inputs to any set of 
+     *        OUTPUTS Transmitters.
+     * 
+     *        Each (input, output) connection is a route carrying a 
+     *        MessageFilter.  When routes change the router compiles them 
+     *        into per input lookup tables of output bitmasks indexed by 
+     *        message type and channel, so routing a message costs two 
+     *        table lookups and one call per output that accepts it.  The 
+     *        message is parsed once and passed to each output by value.
+     * 
+     *        The routing table is double buffered.  attachOutput(), 
+     *        connect() and disconnect() change a pending copy, and commit() 
+     *        publishes it atomically, so routeMessage() never takes a lock 
+     *        and never sees a partly applied change.  Changes must be made
+     *        from one context only, and not from within routeMessage().
+     * 
+     * @tparam INPUTS The number of inputs
+     * @tparam OUTPUTS The number of outputs (at most 32)
+     */
+    template<unsigned int INPUTS, unsigned int OUTPUTS>
+    class Router 
+    {
+        static_assert(OUTPUTS <= 32, "A Router supports at most 32 outputs");
+
+        public:
+            typedef uint32_t OutputMask;
+
+            static constexpr unsigned int TypeCount = 9;
+            static constexpr unsigned int ChannelCount = 16;
+
+            /**
+             * @brief The complete routing configuration.
+             */
+            struct RoutingTable 
+            {
+                Transmitter* outputs[OUTPUTS];
+                MessageFilter routes[INPUTS][OUTPUTS];
+                OutputMask typeOutputs[INPUTS][TypeCount];
+                OutputMask channelOutputs[INPUTS][ChannelCount];
+
+                OutputMask outputsFor(unsigned int input, Message msg) const 
+                {
+                    if (input >= INPUTS) return 0;
+                    Byte status = msg.getStatus();
+                    MessageTypeMask type = MessageFilter::typeBit(status);
+                    if (!type) return 0;
+                    OutputMask hits = typeOutputs[input][__builtin_ctz(type)];
+                    if (status < StatusByte::SystemCommonMin)
+                    {
+                        hits &= channelOutputs[input][status & 0x0F];
+                    }
+                    return hits;
+                }
+
+                void compile(unsigned int input)
+                {
+                    for (unsigned int t = 0; t < TypeCount; t++) 
+                    {
+                        typeOutputs[input][t] = 0;
+                    }
+                    for (unsigned int c = 0; c < ChannelCount; c++) 
+                    {
+                        channelOutputs[input][c] = 0;
+                    }
+                    for (unsigned int o = 0; o < OUTPUTS; o++)
+                    {
+                        const MessageFilter& route = routes[input][o];
+                        OutputMask bit = static_cast<OutputMask>(1) << o;
+                        for (unsigned int t = 0; t < TypeCount; t++)
+                        {
+                            if (route.getTypes() & (1u << t)) 
+                            {
+                                typeOutputs[input][t] |= bit;
+                            }
+                        }
+                        for (unsigned int c = 0; c < ChannelCount; c++)
+                        {
+                            if (route.getChannels() & (1u << c)) 
+                            {
+                                channelOutputs[input][c] |= bit;
+                            }
+                        }
+                    }
+                }
+            };
+
+            Router()
+            {
+                RoutingTable& pending = table.edit();
+                for (unsigned int o = 0; o < OUTPUTS; o++) pending.outputs[o] = nullptr;
+                for (unsigned int i = 0; i < INPUTS; i++)
+                {
+                    for (unsigned int o = 0; o < OUTPUTS; o++)
+                    {
+                        pending.routes[i][o] = MessageFilter(0, 0);
+                    }
+                    pending.compile(i);
+                }
+                table.publish();
+            }
+
+            /**
+             * @brief Attach a transmitter to an output.
+             * 
+             * @param output The output number
+             * @param transmitter The transmitter, or nullptr to dettach
+             */
+            void attachOutput(unsigned int output, Transmitter* transmitter)
+            {
+                if (output < OUTPUTS) table.edit().outputs[output] = transmitter;
+            }
+
+            /**
+             * @brief Connect an input to an output, replacing any existing 
+             *        route between them.
+             * 
+             * @param input The input number
+             * @param output The output number
+             * @param filter The messages that should take this route
+             * @return True if the route was made
+             */
+            bool connect(unsigned int input, unsigned int output, 
+                         MessageFilter filter = MessageFilter())
+            {
+                if ((input >= INPUTS) || (output >= OUTPUTS)) return false;
+                RoutingTable& pending = table.edit();
+                pending.routes[input][output] = filter;
+                pending.compile(input);
+                return true;
+            }
+
+            void disconnect(unsigned int input, unsigned int output)
+            {
+                connect(input, output, MessageFilter(0, 0));
+            }
+
+            void disconnectAll()
+            {
+                for (unsigned int i = 0; i < INPUTS; i++)
+                {
+                    for (unsigned int o = 0; o < OUTPUTS; o++)
+                    {
+                        disconnect(i, o);
+                    }
+                }
+            }
+
+            /**
+             * @brief Make all changes since the last commit live at once.
+             */
+            void commit()
+            {
+                table.publish();
+            }
+
+            /**
+             * @brief Abandon all changes since the last commit.
+             */
+            void discardChanges()
+            {
+                table.discard();
+            }
+
+            /**
+             * @brief Check if an input is connected to an output in the 
+             *        live routing table.
+             */
+            bool isConnected(unsigned int input, unsigned int output) const 
+            {
+                if ((input >= INPUTS) || (output >= OUTPUTS)) return false;
+                return table.live().routes[input][output].getTypes() != 0;
+            }
+
+            /**
+             * @brief Send a message from an input to every output routed 
+             *        to it.
+             */
+            void routeMessage(unsigned int input, Message msg)
+            {
+                typename DoubleBuffer<RoutingTable>::ReadLock live(table);
+                OutputMask hits = live->outputsFor(input, msg);
+                while (hits)
+                {
+                    unsigned int output = __builtin_ctzl(hits);
+                    hits &= hits - 1;
+                    Transmitter* transmitter = live->outputs[output];
+                    if (transmitter) transmitter->sendMessage(msg);
+                }
+            }
+
+        protected:
+            DoubleBuffer<RoutingTable> table;
+    };
+
+    /**
+     * @brief A MIDI input that parses a byte stream and routes the messages
+     *        through a Router.
+     * 
+     *        System exclusive data is not routed.
+     * 
+     * @tparam ROUTER The Router class
+     */
+    template<class ROUTER>
+    class RouterInput: public StaticRxHandler<RouterInput<ROUTER>>
+    {
+        public:
+            RouterInput(ROUTER& inputRouter, unsigned int inputNumber):
+                router(inputRouter), input(inputNumber){};
+
+            void standardMessageReceived(Message msg)
+            {
+                router.routeMessage(input, msg);
+            }
+
+            void realtimeMessageReceived(Message msg, Word timestamp)
+            {
+                router.routeMessage(input, msg);
+            }
+
+            void sysExStatusChanged(bool terminated, bool startedOrValid){};
+
+            void sysExByteReceived(Byte byte){};
+        protected:
+            ROUTER& router;
+            const unsigned int input;
+    };
+
+    /**
+     * @brief Transmitter that delivers messages to an RxHandler, allowing a
+     *        local input device to be a Router output without reparsing.
+     */
+    class ReceiverTransmitter: public Transmitter 
+    {
+        public:
+            ReceiverTransmitter(RxHandler* rxHandler = nullptr): receiver(rxHandler){};
+
+            void attachReceiver(RxHandler* rxHandler){ receiver = rxHandler; };
+
+            void sendMessage(Message msg) override 
+            {
+                if (receiver) receiver->receiveMessage(msg);
+            }
+        protected:
+            RxHandler* receiver;
+    };
+}
+#endif
@@ -49,23 +49,5 @@ void GenericThruDevice::realtimeMessageReceived(Message msg, Word timestamp)
 {   
     auto status = msg.getStatus();
     if (realtimeThruEnabled) this->setRealtimeByte(static_cast<Byte>(status));
-    if (!realtimeCtrl) return;
-    auto code = status.getSystemCommonCode();
-    switch(code)
-    {
-        case SystemCommonCode::TimingClock:
-            realtimeCtrl->registerClockPulse(timestamp);
-            return;
-        case SystemCommonCode::Start:
-            realtimeCtrl->start();
-            return;
-        case SystemCommonCode::Continue:
-            realtimeCtrl->resume();
-            return;
-        case SystemCommonCode::Stop:
-            realtimeCtrl->stop();
-            return;
-        default:
-            return;
-    }
+    dispatchRealtimeMessage(realtimeCtrl, msg, timestamp);
 }
\ No newline at end of file
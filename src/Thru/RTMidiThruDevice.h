@@ -64,6 +64,7 @@
 #include "../Core/RTMidiCore.h"
 #include "../Input/RTMidiInputs.h"
 #include "../Output/RTMidiOutputs.h"
+#include "./RTMidiThruTransforms.h"
 
 namespace RTMIDI 
 {
@@ -72,28 +73,91 @@ namespace RTMIDI
         public:
             GenericThruDevice(InputChannelList devChannels,
                                RealtimeController* realtimeController = nullptr):
-                GenericInputDevice(devChannels, realtimeController){};
+                GenericInputDevice(devChannels, realtimeController),
+                thruEnabled(true),
+                realtimeThruEnabled(true){};
 
             GenericThruDevice(InputChannel* inputChannel,
                                RealtimeController* realtimeController = nullptr):
-                GenericInputDevice(inputChannel, realtimeController){};
+                GenericInputDevice(inputChannel, realtimeController),
+                thruEnabled(true),
+                realtimeThruEnabled(true){};
 
             GenericThruDevice(InputChannel* inputChannels,
                                unsigned int noInputChannels,
                                RealtimeController* realtimeController = nullptr):
                 GenericInputDevice(inputChannels, 
                                    noInputChannels, 
-                                   realtimeController){};
+                                   realtimeController),
+                thruEnabled(true),
+                realtimeThruEnabled(true){};
 
             void realtimeMessageReceived(Message msg, Word timestamp) override;
+
+            /**
+             * @brief Enable or disable forwarding of received messages.  
+             *        Forwarding is enabled by default.
+             * 
+             *        For anything beyond one input to one output, use a 
+             *        Router instead.
+             */
+            void setThruEnabled(bool enabled){ thruEnabled = enabled; };
+
+            /**
+             * @brief Enable or disable forwarding of received realtime 
+             *        messages.  Forwarding is enabled by default.
+             */
+            void setRealtimeThruEnabled(bool enabled)
+            { 
+                realtimeThruEnabled = enabled; 
+            };
+
+            /**
+             * @brief Take a consistent snapshot of the counters of both 
+             *        sides of the device.
+             */
+            DeviceTelemetry getTelemetry() const override 
+            {
+                DeviceTelemetry telemetry;
+                telemetry.clear();
+                readTelemetry(telemetry);
+                return telemetry;
+            }
         protected:
             bool thruEnabled;
             bool realtimeThruEnabled;
+
+            void readTelemetry(DeviceTelemetry& telemetry) const override 
+            {
+                GenericInputDevice::readTelemetry(telemetry);
+                GenericOutputDevice::readTelemetry(telemetry);
+            }
     };
 
-    template<unsigned int BUFFER_LENGTH, typename BUFFER_INDEX = uint8_t>
+    /**
+     * @brief An input device that also forwards received messages to its 
+     *        output.
+     * 
+     *        Held note tracking (trackHeldNotes() and releaseAll()) only 
+     *        covers messages sent with sendMessage() or trySendMessage().  
+     *        Forwarded messages are queued from the receive context, which
+     *        must not update a tracker that the sending context also 
+     *        changes, so notes forwarded by thru are not released by 
+     *        releaseAll().  Send All Notes Off on the affected channels to 
+     *        silence them instead.
+     * 
+     * @tparam BUFFER_LENGTH The length of the message buffers
+     * @tparam BUFFER_INDEX The message buffer index type
+     * @tparam THRU_TRANSFORM A compile time transform (see 
+     *                        RTMidiThruTransforms.h) applied to messages 
+     *                        before they are forwarded.
+     */
+    template<unsigned int BUFFER_LENGTH, 
+             typename BUFFER_INDEX = uint8_t,
+             class THRU_TRANSFORM = PassThrough>
     class ThruDevice: public GenericThruDevice, 
-                       public MessageReceiver<BUFFER_LENGTH, BUFFER_INDEX>
+                       public MessageReceiver<BUFFER_LENGTH, BUFFER_INDEX>,
+                       public OutputQueue<BUFFER_LENGTH, BUFFER_INDEX>
     {
         public:
             ThruDevice(InputChannelList devChannels,
@@ -113,36 +177,52 @@ namespace RTMIDI
             void standardMessageReceived(Message msg) override
             {
                 this->messageBuffer.push(msg);
-                if (this->thruEnabled) this->thruBuffer.push(msg);
+                if (this->thruEnabled && THRU_TRANSFORM::apply(msg))
+                {
+                    this->thruBuffer.push(msg);
+                }
             };
 
             void sendMessage(Message msg) override 
             {
-                transmitBuffer.push(msg);
+                this->queueMessage(msg);
+            }
+
+            bool trySendMessage(Message msg) override 
+            {
+                return this->queueMessage(msg);
             }
 
         protected:
-            MessageBuffer<BUFFER_LENGTH, BUFFER_INDEX> transmitBuffer;
             MessageBuffer<BUFFER_LENGTH, BUFFER_INDEX> thruBuffer;
 
             void processChannelVoiceMessage(Message msg) override
             {
-                channels.dispatchMessage(msg);
+                dispatchChannelVoiceMessage(msg);
             }
 
             void processSystemCommonMessage(Message msg) override {};
 
+            void processingComplete() override
+            {
+                flushChannelBatches();
+            }
+
             Message getNextMessage() override 
             {
                 if (thruBuffer.available())
                 {
-                    return thruBuffer.pop();
+                    return thruBuffer.popTimed(LatencyStage::ThruQueue);
                 }
-                else if (transmitBuffer.available())
-                {
-                    return transmitBuffer.pop();
-                }
-                else return Message::invalid();
+                else return this->takeMessage();
+            }
+
+            void readTelemetry(DeviceTelemetry& telemetry) const override 
+            {
+                GenericThruDevice::readTelemetry(telemetry);
+                this->messageBuffer.readTelemetry(telemetry);
+                thruBuffer.readTelemetry(telemetry);
+                this->transmitBuffer.readTelemetry(telemetry);
             }
     };
 }
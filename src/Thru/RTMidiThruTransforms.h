@@ -0,0 +1,322 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiThruTransforms.h 
+//!  @brief RTMIDI compile time message transform templates
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_THRU_TRANSFORMS_H_
+#define _RT_MIDI_THRU_TRANSFORMS_H_
+
+#include "../Core/RTMidiCore.h"
+
+namespace RTMIDI 
+{
+    /**
+     * Compile time message transforms.
+     * 
+     * A transform is a class with a static member function:
+     * 
+     *      static bool apply(Message& msg);
+     * 
+     * which may modify the message, and returns false if the message should 
+     * be dropped.  Transforms have no state and allocate nothing, so a 
+     * TransformChain of them compiles down to a single inlined function.
+     * 
+     * Example, a ThruDevice that forwards only notes and controllers from 
+     * channel 1, moved to channel 2, an octave up, with a softer velocity
+     * response:
+     * 
+     *      typedef TransformChain<
+     *                  Filter<TypeNotes | TypeControlChange, 1u << Ch1>,
+     *                  RemapChannel<Ch1, Ch2>,
+     *                  Transpose<12>,
+     *                  VelocityCurve<LinearCurve<20, 100>>> MyThru;
+     * 
+     *      ThruDevice<32, uint8_t, MyThru> thru(...);
+     */
+
+    /**
+     * @brief Transform that passes every message unchanged.
+     */
+    struct PassThrough 
+    {
+        static bool apply(Message& msg){ return true; };
+    };
+
+    /**
+     * @brief Passes only messages that match the type and channel masks.
+     * 
+     * @tparam TYPES The MessageType bits to pass
+     * @tparam CHANNELS The channel bits to pass (channel voice messages only)
+     */
+    template<MessageTypeMask TYPES, ChannelMask CHANNELS = AllChannels>
+    struct Filter 
+    {
+        static bool apply(Message& msg)
+        {
+            return MessageFilter::matches(TYPES, CHANNELS, msg.getStatus());
+        }
+    };
+
+    /**
+     * @brief Drops messages that match the type and channel masks.
+     * 
+     * @tparam TYPES The MessageType bits to drop
+     * @tparam CHANNELS The channel bits to drop (channel voice messages only)
+     */
+    template<MessageTypeMask TYPES, ChannelMask CHANNELS = AllChannels>
+    struct Drop 
+    {
+        static bool apply(Message& msg)
+        {
+            return !MessageFilter::matches(TYPES, CHANNELS, msg.getStatus());
+        }
+    };
+
+    /**
+     * @brief Moves channel voice messages from one channel to another.
+     */
+    template<Channel FROM, Channel TO>
+    struct RemapChannel 
+    {
+        static_assert(FROM <= Ch15 && TO <= Ch15, 
+                      "RemapChannel channels must be Ch0 - Ch15");
+
+        static bool apply(Message& msg)
+        {
+            Byte status = msg.getStatus();
+            if ((status < StatusByte::SystemCommonMin) && 
+                (DataByte::lowNibble(status) == FROM))
+            {
+                msg.setStatus(DataByte::setLowNibbleInByte(status, TO));
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Moves all channel voice messages to a single channel.
+     */
+    template<Channel TO>
+    struct ForceChannel 
+    {
+        static_assert(TO <= Ch15, "ForceChannel channel must be Ch0 - Ch15");
+
+        static bool apply(Message& msg)
+        {
+            Byte status = msg.getStatus();
+            if (status < StatusByte::SystemCommonMin)
+            {
+                msg.setStatus(DataByte::setLowNibbleInByte(status, TO));
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Transposes note and polyphonic key pressure messages, clamping
+     *        the result to the range LOW - HIGH.
+     * 
+     * @tparam SEMITONES The number of semitones to transpose by
+     * @tparam LOW The lowest note that may be produced
+     * @tparam HIGH The highest note that may be produced
+     */
+    template<int SEMITONES, Byte LOW = 0, Byte HIGH = DataByte::Max>
+    struct Transpose 
+    {
+        static_assert(LOW <= HIGH && HIGH <= DataByte::Max, 
+                      "Transpose range must be within 0 - 127");
+
+        static bool apply(Message& msg)
+        {
+            StatusCode code = msg.getStatus().getStatusCode();
+            if ((code == StatusCode::NoteOn) || 
+                (code == StatusCode::NoteOff) ||
+                (code == StatusCode::PolyphonicKeyPressure))
+            {
+                int note = msg.getFirstDataByte() + SEMITONES;
+                if (note < LOW) note = LOW;
+                if (note > HIGH) note = HIGH;
+                msg.setDataByte(0, note);
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief A 128 entry lookup table generated at compile time from 
+     *        CURVE::map(), a constexpr function mapping 0 - 127 to a 
+     *        data byte.
+     */
+    template<class CURVE, class SEQUENCE = MakeIndexSequence<DataByte::Max + 1>>
+    struct LookupTable;
+
+    template<class CURVE, unsigned int... INDICES>
+    struct LookupTable<CURVE, IndexSequence<INDICES...>>
+    {
+        static constexpr Byte values[sizeof...(INDICES)] = 
+            { static_cast<Byte>(CURVE::map(INDICES) & DataByte::Max)... };
+
+        static Byte lookup(Byte value)
+        {
+            return values[value & DataByte::Max];
+        }
+    };
+
+    template<class CURVE, unsigned int... INDICES>
+    constexpr Byte LookupTable<CURVE, IndexSequence<INDICES...>>::values[];
+
+    /**
+     * @brief Curve mapping 1 - 127 linearly onto MIN - MAX.  Zero maps to 
+     *        zero so that a note on with zero velocity stays a note off.
+     */
+    template<Byte MIN, Byte MAX>
+    struct LinearCurve 
+    {
+        static_assert(MIN <= MAX && MAX <= DataByte::Max, 
+                      "LinearCurve range must be within 0 - 127 with MIN <= MAX");
+
+        static constexpr Byte map(unsigned int value)
+        {
+            return (value == 0) ? 0 : 
+                MIN + ((value - 1) * (MAX - MIN) + 63) / 126;
+        }
+    };
+
+    /**
+     * @brief Curve mapping every non zero value onto VALUE.
+     */
+    template<Byte VALUE>
+    struct FixedCurve 
+    {
+        static constexpr Byte map(unsigned int value)
+        {
+            return (value == 0) ? 0 : VALUE;
+        }
+    };
+
+    /**
+     * @brief Curve mapping 0 - 127 onto 127 - 0.
+     */
+    struct InvertCurve 
+    {
+        static constexpr Byte map(unsigned int value)
+        {
+            return DataByte::Max - value;
+        }
+    };
+
+    /**
+     * @brief Applies a lookup table generated from CURVE to the velocity 
+     *        of note on messages.  A note on is never turned into a note 
+     *        off; curves returning 0 for a non zero velocity give 1.
+     */
+    template<class CURVE>
+    struct VelocityCurve 
+    {
+        static bool apply(Message& msg)
+        {
+            if (msg.getStatus().getStatusCode() != StatusCode::NoteOn) return true;
+            Byte velocity = msg.getSecondDataByte();
+            if (velocity == 0) return true;
+            velocity = LookupTable<CURVE>::lookup(velocity);
+            msg.setDataByte(1, velocity ? velocity : 1);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Applies a lookup table generated from CURVE to the value of 
+     *        one controller.
+     */
+    template<Byte NUMBER, class CURVE>
+    struct ControllerCurve 
+    {
+        static bool apply(Message& msg)
+        {
+            if ((msg.getStatus().getStatusCode() == StatusCode::ControlChange) &&
+                (msg.getFirstDataByte() == NUMBER))
+            {
+                msg.setDataByte(1, LookupTable<CURVE>::lookup(msg.getSecondDataByte()));
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Applies a list of transforms in order, stopping as soon as 
+     *        one of them drops the message.
+     */
+    template<class... TRANSFORMS>
+    struct TransformChain;
+
+    template<>
+    struct TransformChain<>
+    {
+        static bool apply(Message& msg){ return true; };
+    };
+
+    template<class FIRST, class... REST>
+    struct TransformChain<FIRST, REST...>
+    {
+        static bool apply(Message& msg)
+        {
+            return FIRST::apply(msg) && TransformChain<REST...>::apply(msg);
+        }
+    };
+}
+#endif
@@ -0,0 +1,423 @@
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+//!  @file RTMidiCableMultiplexer.h 
+//!  @brief Shares one USB-MIDI transport between up to 16 virtual cables
+//!
+//!  @author Nate Taylor 
+
+//!  Contact: nate@rtelectronix.com
+//!  @copyright (C) 2020  Nate Taylor - All Rights Reserved.
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |               MMMMMMMMMMMMMMMMMMMMMM   NNNNNNNNNNNNNNNNNN                          |
+//      |              MMMMMMMMM    MMMMMMMMMM       NNNNNMNNN                               |
+//      |              MMMMMMMM:    MMMMMMMMMM       NNNNNNNN                                |
+//      |             MMMMMMMMMMMMMMMMMMMMMMM       NNNNNNNNN                                |
+//      |            MMMMMMMMMMMMMMMMMMMMMM         NNNNNNNN                                 |
+//      |            MMMMMMMM     MMMMMMM          NNNNNNNN                                  |
+//      |           MMMMMMMMM    MMMMMMMM         NNNNNNNNN                                  |
+//      |           MMMMMMMM     MMMMMMM          NNNNNNNN                                   |
+//      |          MMMMMMMM     MMMMMMM          NNNNNNNNN                                   |
+//      |                      MMMMMMMM        NNNNNNNNNN                                    |
+//      |                     MMMMMMMMM       NNNNNNNNNNN                                    |
+//      |                     MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                |
+//      |                   MMMMMMM      E L E C T R O N I X         MMMMMM                  |
+//      |                    MMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMMM                    |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//      |------------------------------------------------------------------------------------|
+//      |                                                                                    |
+//      |      [MIT License]                                                                 |
+//      |                                                                                    |
+//      |      Copyright (c) 2020 Nathaniel Taylor                                           |
+//      |                                                                                    |
+//      |      Permission is hereby granted, free of charge, to any person                   |
+//      |      obtaining a copy of this software and associated documentation                |
+//      |      files (the "Software"), to deal in the Software without                     |
+//      |      restriction, including without limitation the rights to use,                  |
+//      |      copy, modify, merge, publish, distribute, sublicense, and/or sell             |
+//      |      copies of the Software, and to permit persons to whom the Software            |
+//      |      is furnished to do so, subject to the following conditions:                   |
+//      |                                                                                    |
+//      |      The above copyright notice and this permission notice shall be                |
+//      |      included in all copies or substantial portions of the Software.               |
+//      |                                                                                    |
+//      |      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,             |
+//      |      EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES               |
+//      |      OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND                      |
+//      |      NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS           |
+//      |      BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN               |
+//      |      AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF                |
+//      |      OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS               |
+//      |      IN THESOFTWARE.                                                               |
+//      |                                                                                    |
+//      |------------------------------------------------------------------------------------|
+//
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+#ifndef _RT_MIDI_USB_CABLE_MULTIPLEXER_H_
+#define _RT_MIDI_USB_CABLE_MULTIPLEXER_H_
+
+#include "../Core/RTMidiCore.h"
+#include "../Input/RTMidiRXHandler.h"
+#include "../Output/RTMidiTransmitter.h"
+
+namespace RTMIDI 
+{
+    /**
+     * @brief Functions for building and reading USB-MIDI event packets.
+     */
+    class USBEventPacket 
+    {
+        public:
+            /**
+             * @brief Get the number of MIDI bytes in a packet with a code 
+             *        index number.
+             */
+            static constexpr Byte midiLength(Byte codeIndex)
+            {
+                return ((codeIndex == 0x5) || (codeIndex == 0xF)) ? 1 :
+                       ((codeIndex == 0x2) || (codeIndex == 0x6) || 
+                        (codeIndex == 0xC) || (codeIndex == 0xD)) ? 2 :
+                       (codeIndex >= 0x3) ? 3 : 0;
+            }
+
+            /**
+             * @brief Get the code index number of a message, or 
+             *        CodeIndex::Miscellaneous if it can't be sent in one 
+             *        packet.
+             */
+            static CodeIndex codeIndexOf(Message msg)
+            {
+                Byte status = msg.getStatus();
+                if (status < StatusByte::Min) return CodeIndex::Miscellaneous;
+                if (status < StatusByte::SystemCommonMin) 
+                {
+                    return static_cast<CodeIndex>(status >> 4);
+                }
+                if (status >= StatusByte::SystemRealtimeMin) return CodeIndex::SingleByte;
+                switch (static_cast<SystemCommonCode>(status))
+                {
+                    case SystemCommonCode::MTCQuarterFrame:
+                    case SystemCommonCode::SongSelect:
+                        return CodeIndex::SystemCommon2;
+                    case SystemCommonCode::SongPositionPointer:
+                        return CodeIndex::SystemCommon3;
+                    case SystemCommonCode::TuneRequest:
+                        return CodeIndex::SystemCommon1OrSysExEnd1;
+                    default:
+                        return CodeIndex::Miscellaneous;
+                }
+            }
+
+            static USBEventPacketData create(Byte cable, CodeIndex codeIndex,
+                                             Byte byte0, Byte byte1 = 0, 
+                                             Byte byte2 = 0)
+            {
+                USBEventPacketData packet;
+                packet.items.header = ((cable & 0x0F) << 4) | 
+                                      static_cast<Byte>(codeIndex);
+                packet.items.status = byte0;
+                packet.items.data[0] = byte1;
+                packet.items.data[1] = byte2;
+                return packet;
+            }
+
+            /**
+             * @brief Pack a message into a packet.  Unused bytes are 0.
+             */
+            static USBEventPacketData fromMessage(Byte cable, Message msg)
+            {
+                CodeIndex codeIndex = codeIndexOf(msg);
+                Byte length = midiLength(static_cast<Byte>(codeIndex));
+                return create(cable, codeIndex, msg.getStatus(), 
+                              (length > 1) ? static_cast<Byte>(msg.getFirstDataByte()) : 0,
+                              (length > 2) ? static_cast<Byte>(msg.getSecondDataByte()) : 0);
+            }
+
+            static Byte cableOf(USBEventPacketData packet)
+            {
+                return packet.items.header >> 4;
+            }
+
+            static Byte codeIndexOf(USBEventPacketData packet)
+            {
+                return packet.items.header & 0x0F;
+            }
+    };
+
+    /**
+     * @brief Shares one USB-MIDI transport between CABLES virtual cables.
+     * 
+     *        Output: each cable has its own message queue, realtime queue 
+     *        and SysEx buffer, written through sendMessage(), sendSysEx() 
+     *        or a CableOutput transmitter.  getNextPacket() packs one 
+     *        message, or up to three SysEx bytes, per 4 byte event packet.
+     *        Realtime messages go first; everything else is taken from the
+     *        cables round robin, one packet per cable per turn, so a long 
+     *        SysEx on one cable only ever delays the others by one packet.
+     *        Messages on a cable stay in the order they were sent.
+     * 
+     *        Input: receivePacket() demultiplexes received packets to the 
+     *        RxHandler attached to their cable, byte by byte, so every 
+     *        cable keeps its own running status and SysEx state.
+     * 
+     *        Output functions may be called from a different context than 
+     *        getNextPacket(), but each side from only one context.
+     * 
+     * @tparam CABLES The number of cables (1-16)
+     * @tparam QUEUE_LENGTH The message queue length of each cable
+     * @tparam SYSEX_LENGTH The SysEx buffer length of each cable.  It 
+     *                      limits the longest SysEx message that can be 
+     *                      sent to SYSEX_LENGTH - 1 bytes including F0/F7.
+     */
+    template<unsigned int CABLES = 16, 
+             unsigned int QUEUE_LENGTH = 16, 
+             unsigned int SYSEX_LENGTH = 64>
+    class CableMultiplexer 
+    {
+        static_assert((CABLES > 0) && (CABLES <= 16), 
+                      "USB-MIDI supports 1 to 16 cables");
+        static_assert((QUEUE_LENGTH <= 256) && (SYSEX_LENGTH <= 256), 
+                      "Cable buffers are limited to 256 entries");
+
+        public:
+            static constexpr unsigned int RealtimeQueueLength = 4;
+
+            CableMultiplexer(): cables(), nextCable(0){};
+
+            /**
+             * @brief Attach the receiver for a cable's incoming messages.
+             */
+            void attachReceiver(Byte cable, RxHandler* receiver)
+            {
+                if (cable < CABLES) cables[cable].receiver = receiver;
+            }
+
+            /**
+             * @brief Queue a message on a cable.
+             * 
+             * @return False if the cable's queue was full
+             */
+            bool sendMessage(Byte cable, Message msg)
+            {
+                if (cable >= CABLES) return false;
+                Cable& c = cables[cable];
+                if (USBEventPacket::codeIndexOf(msg) == CodeIndex::Miscellaneous)
+                {
+                    return false;
+                }
+                if (msg.getStatus().isSystemRealtime())
+                {
+                    if (c.realtime.isFull()) return drop(c);
+                    c.realtime.push(msg.getStatus());
+                    return true;
+                }
+                if (c.queue.isFull()) return drop(c);
+                c.queue.push(msg);
+                return true;
+            }
+
+            /**
+             * @brief Queue a complete SysEx message on a cable.  The whole 
+             *        message is queued or none of it is.
+             * 
+             * @param cable The cable
+             * @param data The SysEx data bytes, without F0 and F7
+             * @param length The number of data bytes
+             * @return False if the cable's buffers did not have room
+             */
+            bool sendSysEx(Byte cable, const Byte* data, unsigned int length)
+            {
+                if (cable >= CABLES) return false;
+                Cable& c = cables[cable];
+                if (c.queue.isFull() || 
+                    (static_cast<unsigned int>(c.sysEx.freeSpace()) < length + 2))
+                {
+                    return drop(c);
+                }
+                c.sysEx.push(SysExStart);
+                for (unsigned int i = 0; i < length; i++)
+                {
+                    c.sysEx.push(data[i] & DataByte::Max);
+                }
+                c.sysEx.push(SysExEnd);
+                //The marker goes last, so the whole message is in the 
+                //buffer before it can be sent.
+                c.queue.push(Message(SystemCommonCode::SysExStart));
+                return true;
+            }
+
+            /**
+             * @brief Get the next packet to send.
+             * 
+             * @param packet Filled with the packet
+             * @return False if there is nothing to send
+             */
+            bool getNextPacket(USBEventPacketData& packet)
+            {
+                for (Byte i = 0; i < CABLES; i++)
+                {
+                    Cable& c = cables[i];
+                    if (c.realtime.available())
+                    {
+                        packet = USBEventPacket::create(i, CodeIndex::SingleByte, 
+                                                        c.realtime.pop());
+                        return true;
+                    }
+                }
+                for (Byte i = 0; i < CABLES; i++)
+                {
+                    Byte cable = (nextCable + i) % CABLES;
+                    if (getCablePacket(cable, packet))
+                    {
+                        nextCable = (cable + 1) % CABLES;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * @brief Fill a transfer buffer with packets.
+             * 
+             * @param packets The buffer
+             * @param maxPackets The buffer length in packets
+             * @return The number of packets written
+             */
+            unsigned int fillPackets(USBEventPacketData* packets, 
+                                     unsigned int maxPackets)
+            {
+                unsigned int count = 0;
+                while ((count < maxPackets) && getNextPacket(packets[count]))
+                {
+                    count++;
+                }
+                return count;
+            }
+
+            /**
+             * @brief Deliver a received packet to its cable's receiver.
+             * 
+             * @param packet The received packet
+             * @param timestamp (optional) The time the packet was received
+             */
+            void receivePacket(USBEventPacketData packet, Word timestamp = 0)
+            {
+                Byte cable = USBEventPacket::cableOf(packet);
+                if (cable >= CABLES) return;
+                RxHandler* receiver = cables[cable].receiver;
+                if (!receiver) return;
+                Byte length = USBEventPacket::midiLength(
+                                    USBEventPacket::codeIndexOf(packet));
+                for (Byte i = 0; i < length; i++)
+                {
+                    receiver->receiveByte(packet.byte[i + 1], timestamp);
+                }
+            }
+
+            /**
+             * @brief Get the number of messages a cable could not queue.
+             */
+            Word getDroppedCount(Byte cable) const 
+            {
+                return (cable < CABLES) ? cables[cable].dropped : 0;
+            }
+
+        protected:
+            static constexpr Byte SysExStart = 
+                static_cast<Byte>(SystemCommonCode::SysExStart);
+            static constexpr Byte SysExEnd = 
+                static_cast<Byte>(SystemCommonCode::SysExEnd);
+
+            struct Cable 
+            {
+                MessageBuffer<QUEUE_LENGTH, uint8_t> queue;
+                RingBuffer<Byte, SYSEX_LENGTH, uint8_t> sysEx;
+                RingBuffer<Byte, RealtimeQueueLength, uint8_t> realtime;
+                RxHandler* receiver;
+                bool sendingSysEx;
+                Word dropped;
+            };
+
+            Cable cables[CABLES];
+            Byte nextCable;
+
+            static bool drop(Cable& c)
+            {
+                c.dropped++;
+                return false;
+            }
+
+            bool getCablePacket(Byte cable, USBEventPacketData& packet)
+            {
+                Cable& c = cables[cable];
+                if (!c.sendingSysEx)
+                {
+                    if (!c.queue.available()) return false;
+                    Message msg = c.queue.pop();
+                    if (!msg.getStatus().isSystemCommonCode(SystemCommonCode::SysExStart))
+                    {
+                        packet = USBEventPacket::fromMessage(cable, msg);
+                        return true;
+                    }
+                    c.sendingSysEx = true;
+                }
+                Byte bytes[3] = {0, 0, 0};
+                Byte count = 0;
+                while (count < 3)
+                {
+                    bytes[count] = c.sysEx.pop();
+                    count++;
+                    if (bytes[count - 1] == SysExEnd) 
+                    {
+                        c.sendingSysEx = false;
+                        break;
+                    }
+                }
+                CodeIndex codeIndex = c.sendingSysEx ? 
+                    CodeIndex::SysExStartOrContinue :
+                    static_cast<CodeIndex>(
+                        static_cast<Byte>(CodeIndex::SystemCommon1OrSysExEnd1) + count - 1);
+                packet = USBEventPacket::create(cable, codeIndex, 
+                                                bytes[0], bytes[1], bytes[2]);
+                return true;
+            }
+    };
+
+    /**
+     * @brief Transmitter for one cable of a CableMultiplexer, so that 
+     *        output channels can be attached to it.
+     * 
+     * @tparam MULTIPLEXER The CableMultiplexer class
+     */
+    template<class MULTIPLEXER>
+    class CableOutput: public Transmitter 
+    {
+        public:
+            CableOutput(MULTIPLEXER& cableMultiplexer, Byte cableNumber):
+                multiplexer(cableMultiplexer), cable(cableNumber){};
+
+            void sendMessage(Message msg) override 
+            {
+                multiplexer.sendMessage(cable, msg);
+            }
+
+            bool trySendMessage(Message msg) override 
+            {
+                return multiplexer.sendMessage(cable, msg);
+            }
+
+            bool sendSysEx(const Byte* data, unsigned int length)
+            {
+                return multiplexer.sendSysEx(cable, data, length);
+            }
+        protected:
+            MULTIPLEXER& multiplexer;
+            const Byte cable;
+    };
+}
+#endif